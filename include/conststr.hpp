@@ -65,6 +65,10 @@
  * std::cout << str << std::endl;
  * @endcode
  * 
+ * Define `CONSTSTR_NO_IOSTREAM` before including `conststr.hpp` to leave out
+ * `<iostream>` and this operator, e.g. in translation units that only print
+ * through `std::format` or `reflect::print`.
+ * 
  * @subsection compare Compare strings
  * 
  * The `conststr::cstr` instances are compared in lexicographic order:
@@ -228,11 +232,17 @@
 #include <algorithm>
 #include <concepts>
 #include <cstddef>
+#ifndef CONSTSTR_NO_IOSTREAM
 #include <iostream>
+#endif
 #include <iterator>
 #include <string_view>
 #include <tuple>
 #include <type_traits>
+#include <version>
+#if !defined(CONSTSTR_NO_FORMAT) && defined(__cpp_lib_format)
+#include <format>
+#endif
 
 /**
  * @brief The outermost namespace of this library to avoid identifier pollution
@@ -1938,14 +1948,18 @@ constexpr auto flatten(const First &first, const Str &...strs)
     return cstr(first).flatten(strs...);
 }
 
+#ifndef CONSTSTR_NO_IOSTREAM
 /**
  * @brief Output string to std::ostream
+ * @note Define `CONSTSTR_NO_IOSTREAM` before including this header to leave
+ * out `<iostream>` and this operator.
  */
 template <charutils::char_like T, typename U, std::size_t N>
 std::ostream &operator<<(std::ostream &os, const cstr<N, T, U> &str) {
     os << static_cast<typename cstr<N, T, U>::view_type>(str);
     return os;
 }
+#endif
 
 /**
  * @brief Define string literal suffix.
@@ -2029,4 +2043,23 @@ struct std::hash<conststr::cstr<N, T, U>> {
     }
 };
 
+#if !defined(CONSTSTR_NO_FORMAT) && defined(__cpp_lib_format)
+/**
+ * @brief Specialize `std::formatter` for `cstr`, accepting the same format
+ * specifications as `std::basic_string_view`.
+ * @note Define `CONSTSTR_NO_FORMAT` before including this header to drop
+ * `<format>` and this specialization.
+ */
+template <conststr::charutils::char_like T, typename U, std::size_t N>
+struct std::formatter<conststr::cstr<N, T, U>, T>
+    : std::formatter<std::basic_string_view<T>, T> {
+    template <typename FormatContext>
+    auto format(const conststr::cstr<N, T, U> &str,
+                FormatContext &ctx) const {
+        return std::formatter<std::basic_string_view<T>, T>::format(
+            std::basic_string_view<T>(str.data(), N), ctx);
+    }
+};
+#endif
+
 #endif
\ No newline at end of file
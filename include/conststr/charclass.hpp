@@ -0,0 +1,446 @@
+/* MIT License
+ *
+ * Copyright (c) 2024 Nichts Hsu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * @file charclass.hpp
+ * @brief Character-class lookup tables generated from predicates.
+ */
+
+#ifndef CONSTSTR_CHARCLASS_HPP
+#define CONSTSTR_CHARCLASS_HPP
+
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+#if defined(__SSE2__) && !defined(CONSTSTR_NO_SIMD)
+#include <emmintrin.h>
+#define CONSTSTR_CHARCLASS_SSE2
+#endif
+
+#if defined(__SSSE3__) && !defined(CONSTSTR_NO_SIMD)
+#include <tmmintrin.h>
+#define CONSTSTR_CHARCLASS_SSSE3
+#endif
+
+#include "../conststr.hpp"
+
+namespace conststr {
+namespace charutils {
+/**
+ * @brief Internal implementation of `table` and `find_first_of`.
+ * Find the first byte of `str` at or after `pos` for which `byte` returns
+ * `Member`. `block` classifies 16 bytes into a bit mask, or is `nullptr` if
+ * there is no vectorized classification.
+ */
+template <bool Member, typename Byte, typename Block>
+constexpr std::size_t scan_forward(std::string_view str, std::size_t pos,
+                                   Byte byte, Block block) noexcept {
+    if (pos >= str.size()) return std::string_view::npos;
+    if constexpr (!std::is_null_pointer_v<Block>) {
+        if (!std::is_constant_evaluated()) {
+            for (; pos + 16 <= str.size(); pos += 16) {
+                unsigned mask = block(str.data() + pos);
+                if constexpr (!Member) mask = ~mask & 0xFFFF;
+                if (mask) return pos + std::countr_zero(mask);
+            }
+        }
+    }
+    for (; pos < str.size(); ++pos)
+        if (byte(str[pos]) == Member) return pos;
+    return std::string_view::npos;
+}
+
+/**
+ * @brief Internal implementation of `table` and `find_last_of`.
+ * Find the last byte of `str` at or before `pos` for which `byte` returns
+ * `Member`.
+ * @see scan_forward
+ */
+template <bool Member, typename Byte, typename Block>
+constexpr std::size_t scan_backward(std::string_view str, std::size_t pos,
+                                    Byte byte, Block block) noexcept {
+    std::size_t end = pos < str.size() ? pos + 1 : str.size();
+    if constexpr (!std::is_null_pointer_v<Block>) {
+        if (!std::is_constant_evaluated()) {
+            for (; end >= 16; end -= 16) {
+                unsigned mask = block(str.data() + end - 16);
+                if constexpr (!Member) mask = ~mask & 0xFFFF;
+                if (mask) return end - 17 + std::bit_width(mask);
+            }
+        }
+    }
+    while (end > 0)
+        if (byte(str[--end]) == Member) return end;
+    return std::string_view::npos;
+}
+
+/**
+ * @brief Character class of all bytes satisfying `Pred`, tabulated at
+ * compile time.
+ * @details
+ * `Pred` is evaluated for the 256 byte values once at compile time. The
+ * results are kept both as a byte lookup table, which gives a branch-free
+ * `operator()`, and as a 256-bit bitmap.
+ *
+ * The class is also encoded as two 16-entry nibble tables such that byte `b`
+ * belongs to the class if and only if `lo[b & 15] & hi[b >> 4]` is not zero.
+ * This works whenever the high nibbles fall into at most 8 distinct non-empty
+ * columns of low nibbles, which holds for all predicates in `charutils`.
+ * When SSSE3 is enabled, `find` and its variants use it to classify 16
+ * bytes per `pshufb` pair; otherwise, or if the encoding does not exist, they use
+ * the lookup table.
+ *
+ * The table is a predicate itself, so it can be passed to `cstr::find_if`
+ * or the standard algorithms:
+ * @code
+ * constexpr charutils::table<charutils::isalnum<char>> word;
+ * auto end = word.find_not(input);      // end of the leading identifier
+ * auto pos = str.find_if(word);         // cstr::find_if
+ * @endcode
+ * @tparam Pred any predicate callable with `char`, e.g.
+ * `charutils::isxdigit<char>` or a captureless lambda
+ */
+template <auto Pred>
+    requires std::predicate<decltype(Pred), char>
+struct table {
+    /**
+     * @brief Byte lookup table, 1 for the members of the class.
+     */
+    static constexpr std::array<std::uint8_t, 256> lut = [] {
+        std::array<std::uint8_t, 256> ret{};
+        for (int ch = 0; ch < 256; ++ch) ret[ch] = Pred(char(ch)) ? 1 : 0;
+        return ret;
+    }();
+
+    /**
+     * @brief Bitmap of the class, bit `b & 63` of word `b >> 6` for byte `b`.
+     */
+    static constexpr std::array<std::uint64_t, 4> bits = [] {
+        std::array<std::uint64_t, 4> ret{};
+        for (int ch = 0; ch < 256; ++ch)
+            if (lut[ch]) ret[ch >> 6] |= std::uint64_t(1) << (ch & 63);
+        return ret;
+    }();
+
+    /**
+     * @brief Number of bytes in the class.
+     */
+    static constexpr std::size_t size = [] {
+        std::size_t ret = 0;
+        for (auto word : bits) ret += std::popcount(word);
+        return ret;
+    }();
+
+   private:
+    struct nibble_tables {
+        std::array<std::uint8_t, 16> lo{};
+        std::array<std::uint8_t, 16> hi{};
+        bool exact = true;
+    };
+
+    static constexpr nibble_tables nibbles = [] {
+        nibble_tables ret;
+        // one bit per distinct set of low nibbles a high nibble admits
+        std::array<std::uint16_t, 8> columns{};
+        std::size_t count = 0;
+        for (int hi = 0; hi < 16; ++hi) {
+            std::uint16_t column = 0;
+            for (int lo = 0; lo < 16; ++lo)
+                if (lut[hi << 4 | lo]) column |= std::uint16_t(1 << lo);
+            if (column == 0) continue;
+            std::size_t bit = 0;
+            while (bit < count && columns[bit] != column) ++bit;
+            if (bit == count) {
+                if (count == columns.size()) {
+                    ret.exact = false;
+                    return ret;
+                }
+                columns[count++] = column;
+            }
+            ret.hi[hi] = std::uint8_t(1 << bit);
+            for (int lo = 0; lo < 16; ++lo)
+                if (column >> lo & 1) ret.lo[lo] |= std::uint8_t(1 << bit);
+        }
+        return ret;
+    }();
+
+   public:
+    /**
+     * @brief Low-nibble table of the `pshufb` encoding.
+     */
+    static constexpr std::array<std::uint8_t, 16> nibble_lo = nibbles.lo;
+
+    /**
+     * @brief High-nibble table of the `pshufb` encoding.
+     */
+    static constexpr std::array<std::uint8_t, 16> nibble_hi = nibbles.hi;
+
+    /**
+     * @brief Check whether the nibble tables encode the class exactly.
+     */
+    static constexpr bool nibble_exact = nibbles.exact;
+
+    /**
+     * @brief Check whether `ch` belongs to the class.
+     */
+    template <char_like T>
+    constexpr bool operator()(T ch) const noexcept {
+        if constexpr (sizeof(T) == 1)
+            return lut[(unsigned char)ch];
+        else
+            return Pred(ch);
+    }
+
+    /**
+     * @brief Check whether `find` and friends classify 16 bytes at a time.
+     */
+    static constexpr bool vectorized =
+#ifdef CONSTSTR_CHARCLASS_SSSE3
+        nibble_exact;
+#else
+        false;
+#endif
+
+    /**
+     * @brief Find the first byte of `str` in the class at or after `pos`.
+     * @return Its position or `std::string_view::npos`.
+     */
+    static constexpr std::size_t find(std::string_view str,
+                                      std::size_t pos = 0) noexcept {
+        return scan_forward<true>(str, pos, byte, block());
+    }
+
+    /**
+     * @brief Find the first byte of `str` not in the class at or after `pos`.
+     * @return Its position or `std::string_view::npos`.
+     */
+    static constexpr std::size_t find_not(std::string_view str,
+                                          std::size_t pos = 0) noexcept {
+        return scan_forward<false>(str, pos, byte, block());
+    }
+
+    /**
+     * @brief Find the last byte of `str` in the class at or before `pos`.
+     * @return Its position or `std::string_view::npos`.
+     */
+    static constexpr std::size_t rfind(
+        std::string_view str,
+        std::size_t pos = std::string_view::npos) noexcept {
+        return scan_backward<true>(str, pos, byte, block());
+    }
+
+    /**
+     * @brief Find the last byte of `str` not in the class at or before `pos`.
+     * @return Its position or `std::string_view::npos`.
+     */
+    static constexpr std::size_t rfind_not(
+        std::string_view str,
+        std::size_t pos = std::string_view::npos) noexcept {
+        return scan_backward<false>(str, pos, byte, block());
+    }
+
+   private:
+    static constexpr bool byte(char ch) noexcept {
+        return lut[(unsigned char)ch];
+    }
+
+    static constexpr auto block() noexcept {
+#ifdef CONSTSTR_CHARCLASS_SSSE3
+        if constexpr (nibble_exact)
+            return &classify;
+        else
+#endif
+            return nullptr;
+    }
+
+#ifdef CONSTSTR_CHARCLASS_SSSE3
+    /**
+     * @brief Classify 16 bytes, bit `i` of the result is set if byte `i` is
+     * in the class.
+     */
+    static unsigned classify(const char *data) noexcept {
+        const __m128i lo = _mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(nibble_lo.data()));
+        const __m128i hi = _mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(nibble_hi.data()));
+        const __m128i low_bits = _mm_set1_epi8(0x0F);
+        __m128i bytes =
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+        __m128i lo_class =
+            _mm_shuffle_epi8(lo, _mm_and_si128(bytes, low_bits));
+        __m128i hi_class = _mm_shuffle_epi8(
+            hi, _mm_and_si128(_mm_srli_epi16(bytes, 4), low_bits));
+        __m128i none = _mm_cmpeq_epi8(_mm_and_si128(lo_class, hi_class),
+                                      _mm_setzero_si128());
+        return ~unsigned(_mm_movemask_epi8(none)) & 0xFFFF;
+    }
+#endif
+};
+
+/**
+ * @brief Check if `ch` is one of `Chs`.
+ * @details
+ * Unlike `is`, a single character is accepted, so it can parameterize
+ * `table` with any non-empty set.
+ */
+template <char... Chs>
+constexpr bool one_of(char ch) noexcept {
+    return ((ch == Chs) || ...);
+}
+}  // namespace charutils
+
+/**
+ * @brief Internal implementation of `find_first_of` and friends.
+ * @details
+ * Small sets, and sets without a `pshufb` encoding, compare 16 bytes
+ * against each character broadcast to a vector and OR the results. Other
+ * sets use `charutils::table`.
+ */
+template <char... Chs>
+    requires(sizeof...(Chs) > 0)
+struct char_set_scan {
+    using table = charutils::table<charutils::one_of<Chs...>>;
+
+    static constexpr bool compare =
+#ifdef CONSTSTR_CHARCLASS_SSE2
+        sizeof...(Chs) <= 4 || (!table::vectorized && sizeof...(Chs) <= 16);
+#else
+        false;
+#endif
+
+#ifdef CONSTSTR_CHARCLASS_SSE2
+    static unsigned block(const char *data) noexcept {
+        __m128i bytes =
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+        __m128i hits = _mm_setzero_si128();
+        ((hits = _mm_or_si128(hits, _mm_cmpeq_epi8(bytes, _mm_set1_epi8(Chs)))),
+         ...);
+        return unsigned(_mm_movemask_epi8(hits));
+    }
+#endif
+
+    template <bool Member>
+    static constexpr std::size_t forward(std::string_view str,
+                                         std::size_t pos) noexcept {
+#ifdef CONSTSTR_CHARCLASS_SSE2
+        if constexpr (compare)
+            return charutils::scan_forward<Member>(
+                str, pos, charutils::one_of<Chs...>, &block);
+#endif
+        if constexpr (Member)
+            return table::find(str, pos);
+        else
+            return table::find_not(str, pos);
+    }
+
+    template <bool Member>
+    static constexpr std::size_t backward(std::string_view str,
+                                          std::size_t pos) noexcept {
+#ifdef CONSTSTR_CHARCLASS_SSE2
+        if constexpr (compare)
+            return charutils::scan_backward<Member>(
+                str, pos, charutils::one_of<Chs...>, &block);
+#endif
+        if constexpr (Member)
+            return table::rfind(str, pos);
+        else
+            return table::rfind_not(str, pos);
+    }
+};
+
+/**
+ * @brief Find the first character of `str` that is one of `Chs`, like
+ * `strpbrk`.
+ * @details
+ * Works on `cstr` as well as runtime strings, e.g.
+ * `find_first_of<',', ';'>(line)`.
+ * @param pos position at which to start the search
+ * @return Position of the found character or `npos` if not found.
+ */
+template <char... Chs>
+constexpr std::size_t find_first_of(std::string_view str,
+                                    std::size_t pos = 0) noexcept {
+    return char_set_scan<Chs...>::template forward<true>(str, pos);
+}
+
+/**
+ * @brief Find the first character of `str` that is none of `Chs`.
+ * @param pos position at which to start the search
+ * @return Position of the found character or `npos` if not found.
+ */
+template <char... Chs>
+constexpr std::size_t find_first_not_of(std::string_view str,
+                                        std::size_t pos = 0) noexcept {
+    return char_set_scan<Chs...>::template forward<false>(str, pos);
+}
+
+/**
+ * @brief Find the last character of `str` that is one of `Chs`.
+ * @param pos position at which to start the backward search
+ * @return Position of the found character or `npos` if not found.
+ */
+template <char... Chs>
+constexpr std::size_t find_last_of(
+    std::string_view str, std::size_t pos = std::string_view::npos) noexcept {
+    return char_set_scan<Chs...>::template backward<true>(str, pos);
+}
+
+/**
+ * @brief Find the last character of `str` that is none of `Chs`.
+ * @param pos position at which to start the backward search
+ * @return Position of the found character or `npos` if not found.
+ */
+template <char... Chs>
+constexpr std::size_t find_last_not_of(
+    std::string_view str, std::size_t pos = std::string_view::npos) noexcept {
+    return char_set_scan<Chs...>::template backward<false>(str, pos);
+}
+
+/**
+ * @brief Get the length of the run of characters in `Chs` starting at
+ * `pos`, like `strspn`.
+ */
+template <char... Chs>
+constexpr std::size_t span_of(std::string_view str,
+                              std::size_t pos = 0) noexcept {
+    if (pos >= str.size()) return 0;
+    std::size_t end = find_first_not_of<Chs...>(str, pos);
+    return (end == std::string_view::npos ? str.size() : end) - pos;
+}
+
+/**
+ * @brief Get the length of the run of characters in `Chs` ending at the
+ * end of `str`.
+ */
+template <char... Chs>
+constexpr std::size_t rspan_of(std::string_view str) noexcept {
+    std::size_t last = find_last_not_of<Chs...>(str);
+    return last == std::string_view::npos ? str.size() : str.size() - last - 1;
+}
+}  // namespace conststr
+
+#endif  // CONSTSTR_CHARCLASS_HPP
@@ -0,0 +1,549 @@
+/* MIT License
+ *
+ * Copyright (c) 2024 Nichts Hsu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * @file codec.hpp
+ * @brief Base64 and hexadecimal codecs at compile time and runtime.
+ */
+
+#ifndef CONSTSTR_CODEC_HPP
+#define CONSTSTR_CODEC_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__SSSE3__) && !defined(CONSTSTR_NO_SIMD)
+#include <tmmintrin.h>
+#define CONSTSTR_CODEC_SSSE3
+#endif
+
+#include "../conststr.hpp"
+#include "charclass.hpp"
+
+namespace conststr {
+/**
+ * @brief Alphabet of base64 (RFC 4648, section 4).
+ */
+inline constexpr char base64_alphabet[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/**
+ * @brief Alphabet of hexadecimal encoding, lowercase.
+ */
+inline constexpr char hex_alphabet[] = "0123456789abcdef";
+
+/**
+ * @brief Internal implementation of the codecs.
+ * Value of each byte in `alphabet`, or `0xFF` if it is not in it.
+ */
+template <std::size_t N>
+consteval std::array<std::uint8_t, 256> alphabet_values(
+    const char (&alphabet)[N]) {
+    std::array<std::uint8_t, 256> ret{};
+    ret.fill(0xFF);
+    for (std::size_t i = 0; i + 1 < N; ++i)
+        ret[(unsigned char)alphabet[i]] = std::uint8_t(i);
+    return ret;
+}
+
+/**
+ * @brief Value of each byte in `base64_alphabet`, or `0xFF`.
+ */
+inline constexpr std::array<std::uint8_t, 256> base64_values =
+    alphabet_values(base64_alphabet);
+
+/**
+ * @brief Value of each hexadecimal digit of either case, or `0xFF`.
+ */
+inline constexpr std::array<std::uint8_t, 256> hex_values = [] {
+    auto ret = alphabet_values(hex_alphabet);
+    for (int i = 10; i < 16; ++i)
+        ret[(unsigned char)charutils::toupper(hex_alphabet[i])] =
+            std::uint8_t(i);
+    return ret;
+}();
+
+/**
+ * @brief Check whether `ch` is in `base64_alphabet`.
+ */
+constexpr bool isbase64(char ch) noexcept {
+    return base64_values[(unsigned char)ch] != 0xFF;
+}
+
+/**
+ * @brief Get the size of `size` bytes encoded in base64, with padding.
+ */
+constexpr std::size_t base64_encoded_size(std::size_t size) noexcept {
+    return (size + 2) / 3 * 4;
+}
+
+/**
+ * @brief Get the size of the bytes encoded by `str` in padded base64.
+ * @return The size, or `npos` if the size of `str` is not a multiple of 4.
+ */
+constexpr std::size_t base64_decoded_size(std::string_view str) noexcept {
+    if (str.size() % 4) return std::string_view::npos;
+    std::size_t size = str.size() / 4 * 3;
+    if (str.ends_with("==")) return size - 2;
+    if (str.ends_with('=')) return size - 1;
+    return size;
+}
+
+/**
+ * @brief Internal implementation of `base64_encode`.
+ * Encode `in` byte by byte.
+ * @return Pointer past the last written character.
+ */
+constexpr char *base64_encode_scalar(std::string_view in, char *out) noexcept {
+    auto byte = [&](std::size_t i) {
+        return std::uint32_t((unsigned char)in[i]);
+    };
+    std::size_t i = 0;
+    for (; i + 3 <= in.size(); i += 3) {
+        std::uint32_t word = byte(i) << 16 | byte(i + 1) << 8 | byte(i + 2);
+        *out++ = base64_alphabet[word >> 18];
+        *out++ = base64_alphabet[(word >> 12) & 63];
+        *out++ = base64_alphabet[(word >> 6) & 63];
+        *out++ = base64_alphabet[word & 63];
+    }
+    if (i == in.size()) return out;
+    bool two = i + 2 == in.size();
+    std::uint32_t word = byte(i) << 16 | (two ? byte(i + 1) << 8 : 0);
+    *out++ = base64_alphabet[word >> 18];
+    *out++ = base64_alphabet[(word >> 12) & 63];
+    *out++ = two ? base64_alphabet[(word >> 6) & 63] : '=';
+    *out++ = '=';
+    return out;
+}
+
+/**
+ * @brief Internal implementation of `base64_decode`.
+ * Decode padded base64 `in` quad by quad, advancing `out` past the written
+ * bytes.
+ * @return `false` if `in` is not valid base64.
+ */
+constexpr bool base64_decode_scalar(std::string_view in, char *&out) noexcept {
+    if (in.size() % 4) return false;
+    for (std::size_t i = 0; i < in.size(); i += 4) {
+        bool last = i + 4 == in.size();
+        std::uint32_t word = 0;
+        int pads = 0;
+        for (std::size_t j = 0; j < 4; ++j) {
+            char ch = in[i + j];
+            std::uint8_t value = base64_values[(unsigned char)ch];
+            if (last && ch == '=' && (j == 3 || (j == 2 && in[i + 3] == '='))) {
+                value = 0;
+                ++pads;
+            } else if (value == 0xFF) {
+                return false;
+            }
+            word = word << 6 | value;
+        }
+        *out++ = char(word >> 16);
+        if (pads < 2) *out++ = char(word >> 8);
+        if (pads < 1) *out++ = char(word);
+    }
+    return true;
+}
+
+/**
+ * @brief Internal implementation of `hex_encode`.
+ * Encode `in` byte by byte.
+ * @return Pointer past the last written character.
+ */
+constexpr char *hex_encode_scalar(std::string_view in, char *out) noexcept {
+    for (char ch : in) {
+        *out++ = hex_alphabet[(unsigned char)ch >> 4];
+        *out++ = hex_alphabet[(unsigned char)ch & 15];
+    }
+    return out;
+}
+
+/**
+ * @brief Internal implementation of `hex_decode`.
+ * Decode `in` pair by pair, advancing `out` past the written bytes.
+ * @return `false` if `in` is not valid hexadecimal.
+ */
+constexpr bool hex_decode_scalar(std::string_view in, char *&out) noexcept {
+    if (in.size() % 2) return false;
+    for (std::size_t i = 0; i < in.size(); i += 2) {
+        std::uint8_t hi = hex_values[(unsigned char)in[i]];
+        std::uint8_t lo = hex_values[(unsigned char)in[i + 1]];
+        if ((hi | lo) == 0xFF) return false;
+        *out++ = char(hi << 4 | lo);
+    }
+    return true;
+}
+
+#ifdef CONSTSTR_CODEC_SSSE3
+/**
+ * @brief Internal implementation of the codecs.
+ * `pshufb` tables derived from the alphabets.
+ */
+struct codec_tables {
+    using base64_class = charutils::table<isbase64>;
+    using hex_class = charutils::table<charutils::isxdigit<char>>;
+    static_assert(base64_class::nibble_exact && hex_class::nibble_exact);
+
+    // offset from the 6-bit index to its character, per bucket of indices
+    // as computed by `base64_encode`
+    static constexpr std::array<std::int8_t, 16> encode_shift = [] {
+        std::array<std::int8_t, 16> ret{};
+        for (int index = 0; index < 64; ++index) {
+            auto shift = std::int8_t(base64_alphabet[index] - index);
+            int bucket = (index > 51 ? index - 51 : 0) | (index < 26 ? 13 : 0);
+            auto &entry = ret[bucket];
+            if (entry != 0 && entry != shift)
+                throw "codec: alphabet not encodable with pshufb";
+            entry = shift;
+        }
+        return ret;
+    }();
+
+    // offset from the character to its 6-bit value, per high nibble,
+    // except '/' which is moved to the unused slot 1
+    static constexpr std::array<std::int8_t, 16> decode_shift = [] {
+        std::array<std::int8_t, 16> ret{};
+        for (int ch = 0; ch < 128; ++ch) {
+            if (!isbase64(char(ch))) continue;
+            int slot = (ch >> 4) - (ch == '/');
+            auto shift = std::int8_t(base64_values[ch] - ch);
+            if (ret[slot] != 0 && ret[slot] != shift)
+                throw "codec: alphabet not decodable with pshufb";
+            ret[slot] = shift;
+        }
+        return ret;
+    }();
+
+    static __m128i load(const void *data) noexcept {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+    }
+
+    /**
+     * @brief Check that the 16 bytes of `chars` all belong to `Class`.
+     */
+    template <typename Class>
+    static bool valid(__m128i chars) noexcept {
+        const __m128i low_bits = _mm_set1_epi8(0x0F);
+        __m128i lo = _mm_shuffle_epi8(load(Class::nibble_lo.data()),
+                                      _mm_and_si128(chars, low_bits));
+        __m128i hi = _mm_shuffle_epi8(
+            load(Class::nibble_hi.data()),
+            _mm_and_si128(_mm_srli_epi16(chars, 4), low_bits));
+        __m128i bad = _mm_cmpeq_epi8(_mm_and_si128(lo, hi),
+                                     _mm_setzero_si128());
+        return _mm_movemask_epi8(bad) == 0;
+    }
+
+    /**
+     * @brief Encode 12 bytes read from a 16-byte block into 16 characters.
+     */
+    static void base64_encode(const char *in, char *out) noexcept {
+        __m128i bytes = _mm_shuffle_epi8(
+            load(in),
+            _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+        __m128i ac = _mm_mulhi_epu16(
+            _mm_and_si128(bytes, _mm_set1_epi32(0x0FC0FC00)),
+            _mm_set1_epi32(0x04000040));
+        __m128i bd = _mm_mullo_epi16(
+            _mm_and_si128(bytes, _mm_set1_epi32(0x003F03F0)),
+            _mm_set1_epi32(0x01000010));
+        __m128i indices = _mm_or_si128(ac, bd);
+        __m128i buckets = _mm_or_si128(
+            _mm_subs_epu8(indices, _mm_set1_epi8(51)),
+            _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), indices),
+                          _mm_set1_epi8(13)));
+        __m128i chars = _mm_add_epi8(
+            indices,
+            _mm_shuffle_epi8(load(encode_shift.data()), buckets));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out), chars);
+    }
+
+    /**
+     * @brief Decode 16 characters into 12 bytes, writing a 16-byte block.
+     * @return `false` if a character is not in the alphabet.
+     */
+    static bool base64_decode(const char *in, char *out) noexcept {
+        __m128i chars = load(in);
+        if (!valid<base64_class>(chars)) return false;
+        __m128i slots = _mm_add_epi8(
+            _mm_and_si128(_mm_srli_epi16(chars, 4), _mm_set1_epi8(0x0F)),
+            _mm_cmpeq_epi8(chars, _mm_set1_epi8('/')));
+        __m128i values = _mm_add_epi8(
+            chars, _mm_shuffle_epi8(load(decode_shift.data()), slots));
+        __m128i pairs =
+            _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+        __m128i words = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+        __m128i bytes = _mm_shuffle_epi8(
+            words, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1,
+                                 -1, -1, -1));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out), bytes);
+        return true;
+    }
+
+    /**
+     * @brief Encode 16 bytes into 32 hexadecimal digits.
+     */
+    static void hex_encode(const char *in, char *out) noexcept {
+        const __m128i digits = load(hex_alphabet);
+        const __m128i low_bits = _mm_set1_epi8(0x0F);
+        __m128i bytes = load(in);
+        __m128i hi = _mm_shuffle_epi8(
+            digits, _mm_and_si128(_mm_srli_epi16(bytes, 4), low_bits));
+        __m128i lo = _mm_shuffle_epi8(digits, _mm_and_si128(bytes, low_bits));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out),
+                         _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 16),
+                         _mm_unpackhi_epi8(hi, lo));
+    }
+
+    /**
+     * @brief Decode 32 hexadecimal digits into 16 bytes.
+     * @return `false` if a character is not a hexadecimal digit.
+     */
+    static bool hex_decode(const char *in, char *out) noexcept {
+        __m128i first = load(in), second = load(in + 16);
+        if (!valid<hex_class>(first) || !valid<hex_class>(second))
+            return false;
+        // '0'-'9' keep their low nibble, letters get 9 added to it
+        auto values = [](__m128i chars) {
+            __m128i letters = _mm_cmpeq_epi8(
+                _mm_and_si128(chars, _mm_set1_epi8(0x40)),
+                _mm_set1_epi8(0x40));
+            return _mm_add_epi8(_mm_and_si128(chars, _mm_set1_epi8(0x0F)),
+                                _mm_and_si128(letters, _mm_set1_epi8(9)));
+        };
+        const __m128i weights = _mm_set1_epi16(0x0110);
+        __m128i bytes = _mm_packus_epi16(
+            _mm_maddubs_epi16(values(first), weights),
+            _mm_maddubs_epi16(values(second), weights));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out), bytes);
+        return true;
+    }
+};
+#endif
+
+/**
+ * @brief Encode `Str` in base64 at compile time.
+ * @return `cstr` of size `base64_encoded_size(Str.size())`.
+ */
+template <cstr Str>
+    requires std::same_as<typename decltype(Str)::value_type, char>
+consteval auto base64_encode() {
+    cstr<base64_encoded_size(Str.size())> ret{};
+    base64_encode_scalar(std::string_view(Str), ret.data());
+    return ret;
+}
+
+/**
+ * @brief Decode padded base64 `Str` at compile time.
+ * @details
+ * Invalid input is a compile error.
+ * @return `cstr` holding the decoded bytes.
+ */
+template <cstr Str>
+    requires std::same_as<typename decltype(Str)::value_type, char>
+consteval auto base64_decode() {
+    constexpr std::size_t size = base64_decoded_size(std::string_view(Str));
+    if constexpr (size == std::string_view::npos) {
+        throw "base64: size not a multiple of 4";
+    } else {
+        cstr<size> ret{};
+        char *out = ret.data();
+        if (!base64_decode_scalar(std::string_view(Str), out))
+            throw "base64: invalid input";
+        return ret;
+    }
+}
+
+/**
+ * @brief Encode `Str` in lowercase hexadecimal at compile time.
+ * @return `cstr` of size `2 * Str.size()`.
+ */
+template <cstr Str>
+    requires std::same_as<typename decltype(Str)::value_type, char>
+consteval auto hex_encode() {
+    cstr<Str.size() * 2> ret{};
+    hex_encode_scalar(std::string_view(Str), ret.data());
+    return ret;
+}
+
+/**
+ * @brief Decode hexadecimal `Str`, of either case, at compile time.
+ * @details
+ * Invalid input is a compile error.
+ * @return `cstr` of size `Str.size() / 2`.
+ */
+template <cstr Str>
+    requires std::same_as<typename decltype(Str)::value_type, char>
+consteval auto hex_decode() {
+    if constexpr (Str.size() % 2) {
+        throw "hex: odd size";
+    } else {
+        cstr<Str.size() / 2> ret{};
+        char *out = ret.data();
+        if (!hex_decode_scalar(std::string_view(Str), out))
+            throw "hex: invalid input";
+        return ret;
+    }
+}
+
+/**
+ * @brief Internal implementation of the runtime codecs.
+ */
+inline std::string_view as_chars(std::span<const std::byte> bytes) noexcept {
+    return {reinterpret_cast<const char *>(bytes.data()), bytes.size()};
+}
+
+/**
+ * @brief Encode `in` in base64 into `out`, which must hold
+ * `base64_encoded_size(in.size())` characters.
+ * @return Pointer past the last written character.
+ */
+inline char *base64_encode(std::span<const std::byte> in, char *out) noexcept {
+    std::string_view chars = as_chars(in);
+    std::size_t pos = 0;
+#ifdef CONSTSTR_CODEC_SSSE3
+    for (; pos + 16 <= chars.size(); pos += 12, out += 16)
+        codec_tables::base64_encode(chars.data() + pos, out);
+#endif
+    return base64_encode_scalar(chars.substr(pos), out);
+}
+
+/**
+ * @brief Encode `in` in base64.
+ */
+inline std::string base64_encode(std::span<const std::byte> in) {
+    std::string ret(base64_encoded_size(in.size()), '\0');
+    base64_encode(in, ret.data());
+    return ret;
+}
+
+/**
+ * @brief Encode the bytes of `in` in base64.
+ */
+inline std::string base64_encode(std::string_view in) {
+    return base64_encode(std::as_bytes(std::span(in)));
+}
+
+/**
+ * @brief Decode padded base64 `in` into `out`, which must hold
+ * `base64_decoded_size(in)` bytes.
+ * @return Pointer past the last written byte.
+ * @throw std::runtime_error if `in` is not valid base64.
+ */
+inline std::byte *base64_decode(std::string_view in, std::byte *out) {
+    auto *dst = reinterpret_cast<char *>(out);
+    std::size_t pos = 0;
+#ifdef CONSTSTR_CODEC_SSSE3
+    // 24 characters left guarantee 16 bytes of room for the store and no
+    // padding in the block
+    for (; pos + 24 <= in.size(); pos += 16, dst += 12)
+        if (!codec_tables::base64_decode(in.data() + pos, dst)) break;
+#endif
+    if (!base64_decode_scalar(in.substr(pos), dst))
+        throw std::runtime_error("base64: invalid input");
+    return reinterpret_cast<std::byte *>(dst);
+}
+
+/**
+ * @brief Decode padded base64 `in`.
+ * @throw std::runtime_error if `in` is not valid base64.
+ */
+inline std::vector<std::byte> base64_decode(std::string_view in) {
+    std::size_t size = base64_decoded_size(in);
+    if (size == std::string_view::npos)
+        throw std::runtime_error("base64: size not a multiple of 4");
+    std::vector<std::byte> ret(size);
+    base64_decode(in, ret.data());
+    return ret;
+}
+
+/**
+ * @brief Encode `in` in lowercase hexadecimal into `out`, which must hold
+ * `2 * in.size()` characters.
+ * @return Pointer past the last written character.
+ */
+inline char *hex_encode(std::span<const std::byte> in, char *out) noexcept {
+    std::string_view chars = as_chars(in);
+    std::size_t pos = 0;
+#ifdef CONSTSTR_CODEC_SSSE3
+    for (; pos + 16 <= chars.size(); pos += 16, out += 32)
+        codec_tables::hex_encode(chars.data() + pos, out);
+#endif
+    return hex_encode_scalar(chars.substr(pos), out);
+}
+
+/**
+ * @brief Encode `in` in lowercase hexadecimal.
+ */
+inline std::string hex_encode(std::span<const std::byte> in) {
+    std::string ret(in.size() * 2, '\0');
+    hex_encode(in, ret.data());
+    return ret;
+}
+
+/**
+ * @brief Encode the bytes of `in` in lowercase hexadecimal.
+ */
+inline std::string hex_encode(std::string_view in) {
+    return hex_encode(std::as_bytes(std::span(in)));
+}
+
+/**
+ * @brief Decode hexadecimal `in`, of either case, into `out`, which must
+ * hold `in.size() / 2` bytes.
+ * @return Pointer past the last written byte.
+ * @throw std::runtime_error if `in` is not valid hexadecimal.
+ */
+inline std::byte *hex_decode(std::string_view in, std::byte *out) {
+    auto *dst = reinterpret_cast<char *>(out);
+    std::size_t pos = 0;
+#ifdef CONSTSTR_CODEC_SSSE3
+    for (; pos + 32 <= in.size(); pos += 32, dst += 16)
+        if (!codec_tables::hex_decode(in.data() + pos, dst)) break;
+#endif
+    if (!hex_decode_scalar(in.substr(pos), dst))
+        throw std::runtime_error("hex: invalid input");
+    return reinterpret_cast<std::byte *>(dst);
+}
+
+/**
+ * @brief Decode hexadecimal `in`, of either case.
+ * @throw std::runtime_error if `in` is not valid hexadecimal.
+ */
+inline std::vector<std::byte> hex_decode(std::string_view in) {
+    if (in.size() % 2) throw std::runtime_error("hex: odd size");
+    std::vector<std::byte> ret(in.size() / 2);
+    hex_decode(in, ret.data());
+    return ret;
+}
+}  // namespace conststr
+
+#endif  // CONSTSTR_CODEC_HPP
@@ -0,0 +1,362 @@
+/* MIT License
+ *
+ * Copyright (c) 2024 Nichts Hsu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * @file escape.hpp
+ * @brief Escaping for JSON, C, HTML and URLs at compile time and runtime.
+ */
+
+#ifndef CONSTSTR_ESCAPE_HPP
+#define CONSTSTR_ESCAPE_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "../conststr.hpp"
+#include "charclass.hpp"
+
+namespace conststr {
+/**
+ * @brief Internal implementation of the escapers.
+ * Hexadecimal digits.
+ */
+inline constexpr char escape_hex_digits[] = "0123456789ABCDEF";
+
+/**
+ * @brief Escaping policy for JSON strings.
+ * @details
+ * `"` and `\` are escaped with a backslash, control characters with their
+ * short form or `\u00XX`. Other bytes, including UTF-8, are kept.
+ */
+struct json_escaper {
+    static constexpr bool needs(char ch) noexcept {
+        return (unsigned char)ch < 0x20 || ch == '"' || ch == '\\';
+    }
+
+    static constexpr std::size_t size(char ch) noexcept {
+        switch (ch) {
+            case '"': case '\\': case '\b': case '\f': case '\n': case '\r':
+            case '\t':
+                return 2;
+            default:
+                return needs(ch) ? 6 : 1;
+        }
+    }
+
+    static constexpr char *write(char *out, char ch) noexcept {
+        char code = 0;
+        switch (ch) {
+            case '"': code = '"'; break;
+            case '\\': code = '\\'; break;
+            case '\b': code = 'b'; break;
+            case '\f': code = 'f'; break;
+            case '\n': code = 'n'; break;
+            case '\r': code = 'r'; break;
+            case '\t': code = 't'; break;
+            default:
+                if (!needs(ch)) {
+                    *out++ = ch;
+                    return out;
+                }
+                for (char c : {'\\', 'u', '0', '0'}) *out++ = c;
+                *out++ = escape_hex_digits[(unsigned char)ch >> 4];
+                *out++ = escape_hex_digits[(unsigned char)ch & 15];
+                return out;
+        }
+        *out++ = '\\';
+        *out++ = code;
+        return out;
+    }
+};
+
+/**
+ * @brief Escaping policy for C string literals.
+ * @details
+ * `"`, `\` and the control characters with a short form are escaped with a
+ * backslash; other bytes outside printable ASCII become three-digit octal
+ * escapes, which cannot run into a following digit.
+ */
+struct c_escaper {
+    static constexpr bool needs(char ch) noexcept {
+        return !charutils::isprint(ch) || ch == '"' || ch == '\\';
+    }
+
+    static constexpr char short_form(char ch) noexcept {
+        switch (ch) {
+            case '"': return '"';
+            case '\\': return '\\';
+            case '\a': return 'a';
+            case '\b': return 'b';
+            case '\f': return 'f';
+            case '\n': return 'n';
+            case '\r': return 'r';
+            case '\t': return 't';
+            case '\v': return 'v';
+            default: return 0;
+        }
+    }
+
+    static constexpr std::size_t size(char ch) noexcept {
+        return !needs(ch) ? 1 : short_form(ch) ? 2 : 4;
+    }
+
+    static constexpr char *write(char *out, char ch) noexcept {
+        if (!needs(ch)) {
+            *out++ = ch;
+        } else if (char code = short_form(ch)) {
+            *out++ = '\\';
+            *out++ = code;
+        } else {
+            auto byte = (unsigned char)ch;
+            *out++ = '\\';
+            *out++ = char('0' + (byte >> 6));
+            *out++ = char('0' + ((byte >> 3) & 7));
+            *out++ = char('0' + (byte & 7));
+        }
+        return out;
+    }
+};
+
+/**
+ * @brief Escaping policy for HTML text and attribute values.
+ * @details
+ * `&`, `<`, `>`, `"` and `'` are replaced with character references.
+ */
+struct html_escaper {
+    static constexpr bool needs(char ch) noexcept {
+        return ch == '&' || ch == '<' || ch == '>' || ch == '"' || ch == '\'';
+    }
+
+    static constexpr std::string_view reference(char ch) noexcept {
+        switch (ch) {
+            case '&': return "&amp;";
+            case '<': return "&lt;";
+            case '>': return "&gt;";
+            case '"': return "&quot;";
+            case '\'': return "&#39;";
+            default: return {};
+        }
+    }
+
+    static constexpr std::size_t size(char ch) noexcept {
+        return needs(ch) ? reference(ch).size() : 1;
+    }
+
+    static constexpr char *write(char *out, char ch) noexcept {
+        if (!needs(ch)) {
+            *out++ = ch;
+            return out;
+        }
+        for (char c : reference(ch)) *out++ = c;
+        return out;
+    }
+};
+
+/**
+ * @brief Escaping policy for URL components (RFC 3986 percent-encoding).
+ * @details
+ * Every byte except the unreserved characters `A-Z a-z 0-9 - . _ ~` is
+ * replaced with `%XX`.
+ */
+struct url_escaper {
+    static constexpr bool needs(char ch) noexcept {
+        return !(charutils::isalnum(ch) || ch == '-' || ch == '.' ||
+                 ch == '_' || ch == '~');
+    }
+
+    static constexpr std::size_t size(char ch) noexcept {
+        return needs(ch) ? 3 : 1;
+    }
+
+    static constexpr char *write(char *out, char ch) noexcept {
+        if (!needs(ch)) {
+            *out++ = ch;
+            return out;
+        }
+        *out++ = '%';
+        *out++ = escape_hex_digits[(unsigned char)ch >> 4];
+        *out++ = escape_hex_digits[(unsigned char)ch & 15];
+        return out;
+    }
+};
+
+/**
+ * @brief Escape `Str` at compile time according to `Escaper`.
+ * @details
+ * A counting pass gives the exact size of the result.
+ * @tparam Escaper escaping policy, e.g. `json_escaper`
+ * @tparam Str string to escape
+ * @return `cstr` holding the escaped string.
+ */
+template <typename Escaper, cstr Str>
+    requires std::same_as<typename decltype(Str)::value_type, char>
+consteval auto escape() {
+    constexpr std::size_t size = [] {
+        std::size_t ret = 0;
+        for (char ch : Str) ret += Escaper::size(ch);
+        return ret;
+    }();
+    cstr<size> ret{};
+    char *out = ret.data();
+    for (char ch : Str) out = Escaper::write(out, ch);
+    return ret;
+}
+
+/**
+ * @brief Append `str` escaped according to `Escaper` to `out`.
+ * @details
+ * The bytes needing an escape are located with `charutils::table` of
+ * `Escaper::needs`, 16 at a time where SIMD is available, and the clean
+ * spans between them are appended in bulk.
+ * @tparam Escaper escaping policy, e.g. `json_escaper`
+ */
+template <typename Escaper>
+void escape(std::string_view str, std::string &out) {
+    using table = charutils::table<Escaper::needs>;
+    out.reserve(out.size() + str.size());
+    std::size_t pos = 0;
+    while (pos < str.size()) {
+        std::size_t next = table::find(str, pos);
+        if (next == std::string_view::npos) next = str.size();
+        out.append(str.data() + pos, next - pos);
+        if (next == str.size()) break;
+        char buffer[8];
+        out.append(buffer, Escaper::write(buffer, str[next]));
+        pos = next + 1;
+    }
+}
+
+/**
+ * @brief Escape `str` according to `Escaper`.
+ * @tparam Escaper escaping policy, e.g. `json_escaper`
+ */
+template <typename Escaper>
+std::string escape(std::string_view str) {
+    std::string ret;
+    escape<Escaper>(str, ret);
+    return ret;
+}
+
+/**
+ * @brief Escape `Str` for a JSON string at compile time.
+ * @see json_escaper
+ */
+template <cstr Str>
+consteval auto escape_json() {
+    return escape<json_escaper, Str>();
+}
+
+/**
+ * @brief Append `str` escaped for a JSON string to `out`.
+ * @see json_escaper
+ */
+inline void escape_json(std::string_view str, std::string &out) {
+    escape<json_escaper>(str, out);
+}
+
+/**
+ * @brief Escape `str` for a JSON string.
+ * @see json_escaper
+ */
+inline std::string escape_json(std::string_view str) {
+    return escape<json_escaper>(str);
+}
+
+/**
+ * @brief Escape `Str` for a C string literal at compile time.
+ * @see c_escaper
+ */
+template <cstr Str>
+consteval auto escape_c() {
+    return escape<c_escaper, Str>();
+}
+
+/**
+ * @brief Append `str` escaped for a C string literal to `out`.
+ * @see c_escaper
+ */
+inline void escape_c(std::string_view str, std::string &out) {
+    escape<c_escaper>(str, out);
+}
+
+/**
+ * @brief Escape `str` for a C string literal.
+ * @see c_escaper
+ */
+inline std::string escape_c(std::string_view str) {
+    return escape<c_escaper>(str);
+}
+
+/**
+ * @brief Escape `Str` for HTML at compile time.
+ * @see html_escaper
+ */
+template <cstr Str>
+consteval auto escape_html() {
+    return escape<html_escaper, Str>();
+}
+
+/**
+ * @brief Append `str` escaped for HTML to `out`.
+ * @see html_escaper
+ */
+inline void escape_html(std::string_view str, std::string &out) {
+    escape<html_escaper>(str, out);
+}
+
+/**
+ * @brief Escape `str` for HTML.
+ * @see html_escaper
+ */
+inline std::string escape_html(std::string_view str) {
+    return escape<html_escaper>(str);
+}
+
+/**
+ * @brief Percent-encode `Str` at compile time.
+ * @see url_escaper
+ */
+template <cstr Str>
+consteval auto url_encode() {
+    return escape<url_escaper, Str>();
+}
+
+/**
+ * @brief Append `str` percent-encoded to `out`.
+ * @see url_escaper
+ */
+inline void url_encode(std::string_view str, std::string &out) {
+    escape<url_escaper>(str, out);
+}
+
+/**
+ * @brief Percent-encode `str`.
+ * @see url_escaper
+ */
+inline std::string url_encode(std::string_view str) {
+    return escape<url_escaper>(str);
+}
+}  // namespace conststr
+
+#endif  // CONSTSTR_ESCAPE_HPP
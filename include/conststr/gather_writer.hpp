@@ -0,0 +1,329 @@
+/* MIT License
+ *
+ * Copyright (c) 2024 Nichts Hsu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * @file gather_writer.hpp
+ * @brief Batched output of string fragments with `writev`.
+ * @note Requires POSIX `writev`.
+ */
+
+#ifndef CONSTSTR_GATHER_WRITER_HPP
+#define CONSTSTR_GATHER_WRITER_HPP
+
+#if defined(_WIN32)
+#error "conststr/gather_writer.hpp requires POSIX writev."
+#endif
+
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#include "../conststr.hpp"
+
+namespace conststr {
+/**
+ * @brief Output utilities without `std::ostream`.
+ */
+namespace io {
+/**
+ * @brief Capacity of `gather_writer` which grows on demand.
+ */
+constexpr std::size_t dynamic = std::size_t(-1);
+
+/**
+ * @brief Internal implementation of `gather_writer`.
+ * Vector of at most `N` elements without allocation, or `std::vector` if `N`
+ * is `dynamic`.
+ */
+template <typename T, std::size_t N>
+class bounded_vector {
+   public:
+    static constexpr bool fixed = true;
+    std::size_t size() const noexcept { return _size; }
+    bool full() const noexcept { return _size == N; }
+    std::size_t room() const noexcept { return N - _size; }
+    T *data() noexcept { return _data.data(); }
+    T &back() noexcept { return _data[_size - 1]; }
+    T &operator[](std::size_t i) noexcept { return _data[i]; }
+    void push_back(const T &value) noexcept { _data[_size++] = value; }
+    void resize(std::size_t size) noexcept { _size = size; }
+    void clear() noexcept { _size = 0; }
+
+   private:
+    std::array<T, N> _data{};
+    std::size_t _size = 0;
+};
+
+template <typename T>
+class bounded_vector<T, dynamic> {
+   public:
+    static constexpr bool fixed = false;
+    std::size_t size() const noexcept { return _data.size(); }
+    bool full() const noexcept { return false; }
+    std::size_t room() const noexcept { return std::size_t(-1); }
+    T *data() noexcept { return _data.data(); }
+    T &back() noexcept { return _data.back(); }
+    T &operator[](std::size_t i) noexcept { return _data[i]; }
+    void push_back(const T &value) { _data.push_back(value); }
+    void resize(std::size_t size) { _data.resize(size); }
+    void clear() noexcept { _data.clear(); }
+
+   private:
+    std::vector<T> _data;
+};
+
+/**
+ * @brief Collect string fragments and write them with one `writev` call.
+ * @details
+ * Fragments are referenced, not copied: constant `cstr` fragments passed as
+ * template arguments live forever, and runtime fragments must stay valid
+ * until the next `flush`. Fragments shorter than the coalescing threshold,
+ * constant or not, are copied into a staging buffer instead, merging
+ * adjacent small fragments into one `iovec`. For example:
+ * @code{.cpp}
+ * conststr::io::gather_writer<> out(fd);
+ * out.append<"HTTP/1.1 200 OK\r\nContent-Length: "_cs>();
+ * out.append(length_text);
+ * out.append<"\r\n\r\n"_cs>();
+ * out.append(body);
+ * out.flush();
+ * @endcode
+ * With both capacities fixed, the writer never allocates and flushes
+ * automatically when either the fragment list or the staging buffer is full.
+ * @tparam MaxFragments maximum number of pending fragments, or `dynamic`
+ * @tparam StageSize size of the staging buffer in bytes, or `dynamic`
+ */
+template <std::size_t MaxFragments = dynamic, std::size_t StageSize = dynamic>
+class gather_writer {
+    struct fragment {
+        const char *data;    // nullptr if staged
+        std::size_t offset;  // offset into the staging buffer if staged
+        std::size_t size;
+    };
+
+    static_assert(MaxFragments > 0, "gather_writer: MaxFragments is zero");
+
+   public:
+    /**
+     * @brief Construct a writer to the file descriptor `fd`.
+     * @param fd file descriptor, not owned by the writer
+     * @param coalesce_below fragments shorter than this are copied into the
+     * staging buffer
+     */
+    explicit gather_writer(int fd, std::size_t coalesce_below = 64) noexcept
+        : _fd(fd), _threshold(coalesce_below) {}
+
+    gather_writer(const gather_writer &) = delete;
+    gather_writer &operator=(const gather_writer &) = delete;
+
+    /**
+     * @brief Flush pending fragments, ignoring errors.
+     */
+    ~gather_writer() {
+        try {
+            flush();
+        } catch (...) {
+        }
+    }
+
+    /**
+     * @brief Append the constant fragment `Str`.
+     * @details `Str` is referenced in place, since it lives forever, unless
+     * it is shorter than the coalescing threshold: then it is copied into the
+     * staging buffer like any other short fragment.
+     * @tparam Str string to append
+     */
+    template <cstr Str>
+    void append()
+        requires std::same_as<typename decltype(Str)::value_type, char>
+    {
+        append(std::string_view(Str.data(), Str.size()));
+    }
+
+    /**
+     * @brief Append a runtime fragment.
+     * @param str fragment which must stay valid until the next `flush`,
+     * unless it is shorter than the coalescing threshold
+     */
+    void append(std::string_view str) {
+        if (str.empty()) return;
+        if (str.size() < _threshold && str.size() <= StageSize) {
+            stage(str);
+            return;
+        }
+        if (_fragments.full()) flush();
+        _fragments.push_back({str.data(), 0, str.size()});
+        _pending += str.size();
+    }
+
+    /**
+     * @brief Append a runtime fragment of raw bytes.
+     * @param bytes fragment which must stay valid until the next `flush`,
+     * unless it is shorter than the coalescing threshold
+     */
+    void append(std::span<const std::byte> bytes) {
+        append(std::string_view(reinterpret_cast<const char *>(bytes.data()),
+                                bytes.size()));
+    }
+
+    /**
+     * @brief Copy `str` into the staging buffer regardless of its size.
+     * @note In fixed mode, `str` larger than `StageSize` cannot be copied, so
+     * pending fragments and `str` are written immediately instead.
+     */
+    void stage(std::string_view str) {
+        if constexpr (decltype(_stage)::fixed) {
+            if (str.size() > StageSize) {
+                flush();
+                _fragments.push_back({str.data(), 0, str.size()});
+                _pending = str.size();
+                try {
+                    flush();
+                } catch (...) {
+                    // `str` may not outlive this call, drop what is left.
+                    _fragments.clear();
+                    _pending = 0;
+                    throw;
+                }
+                return;
+            }
+            if (str.size() > _stage.room()) flush();
+        }
+        std::size_t offset = _stage.size();
+        _stage.resize(offset + str.size());
+        std::memcpy(_stage.data() + offset, str.data(), str.size());
+        _pending += str.size();
+        if (_fragments.size() != 0 && !_fragments.back().data &&
+            _fragments.back().offset + _fragments.back().size == offset) {
+            _fragments.back().size += str.size();
+            return;
+        }
+        if (_fragments.full()) {
+            // Keep the bytes just staged: flush the others and restart.
+            _stage.resize(offset);
+            _pending -= str.size();
+            flush();
+            stage(str);
+            return;
+        }
+        _fragments.push_back({nullptr, offset, str.size()});
+    }
+
+    /**
+     * @brief Write all pending fragments with as few `writev` calls as
+     * possible.
+     * @exception std::system_error if writing fails or `writev` writes
+     * nothing. The bytes written before the failure are dropped, so the next
+     * `flush` resumes after them.
+     */
+    void flush() {
+        constexpr std::size_t batch = 64;
+        std::size_t first = 0, skip = 0, done = 0;
+        while (first < _fragments.size()) {
+            iovec iov[batch];
+            std::size_t count = 0;
+            for (std::size_t i = first; i < _fragments.size() && count < batch;
+                 ++i, ++count) {
+                const fragment &f = _fragments[i];
+                const char *data = f.data ? f.data : _stage.data() + f.offset;
+                std::size_t from = i == first ? skip : 0;
+                iov[count].iov_base = const_cast<char *>(data + from);
+                iov[count].iov_len = f.size - from;
+            }
+            ssize_t written = ::writev(_fd, iov, int(count));
+            if (written <= 0) {
+                if (written < 0 && errno == EINTR) continue;
+                // Writing nothing while bytes are pending would loop forever.
+                int error = written < 0 ? errno : EIO;
+                consume(first, skip, done);
+                throw std::system_error(error, std::generic_category(),
+                                        "writev");
+            }
+            done += std::size_t(written);
+            std::size_t left = std::size_t(written);
+            for (std::size_t i = 0; i < count && left > 0; ++i) {
+                std::size_t size = iov[i].iov_len;
+                if (left < size) {
+                    skip += left;
+                    left = 0;
+                } else {
+                    left -= size;
+                    ++first;
+                    skip = 0;
+                }
+            }
+        }
+        _fragments.clear();
+        _stage.clear();
+        _pending = 0;
+    }
+
+    /**
+     * @brief Get the number of bytes waiting for `flush`.
+     */
+    std::size_t pending() const noexcept { return _pending; }
+
+    /**
+     * @brief Get the number of `iovec` entries waiting for `flush`.
+     */
+    std::size_t fragments() const noexcept { return _fragments.size(); }
+
+   private:
+    /**
+     * @brief Drop the first `count` fragments and `skip` bytes of the next
+     * one, `done` bytes in total, after they have been written.
+     */
+    void consume(std::size_t count, std::size_t skip, std::size_t done) {
+        std::size_t left = _fragments.size() - count;
+        for (std::size_t i = 0; i < left; ++i)
+            _fragments[i] = _fragments[count + i];
+        _fragments.resize(left);
+        if (skip != 0) {
+            fragment &f = _fragments[0];
+            if (f.data)
+                f.data += skip;
+            else
+                f.offset += skip;
+            f.size -= skip;
+        }
+        _pending -= done;
+    }
+
+    int _fd;
+    std::size_t _threshold;
+    std::size_t _pending = 0;
+    bounded_vector<fragment, MaxFragments> _fragments;
+    bounded_vector<char, StageSize> _stage;
+};
+}  // namespace io
+}  // namespace conststr
+
+#endif
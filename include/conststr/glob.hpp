@@ -0,0 +1,295 @@
+/* MIT License
+ *
+ * Copyright (c) 2024 Nichts Hsu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * @file glob.hpp
+ * @brief Wildcard patterns compiled at compile time.
+ */
+
+#ifndef CONSTSTR_GLOB_HPP
+#define CONSTSTR_GLOB_HPP
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#include "../conststr.hpp"
+
+namespace conststr {
+/**
+ * @brief Set of bytes as a 256-bit bitmap.
+ */
+struct char_set {
+    std::array<std::uint64_t, 4> bits{};
+
+    /**
+     * @brief Add the byte `ch`.
+     */
+    constexpr void add(unsigned char ch) noexcept {
+        bits[ch >> 6] |= std::uint64_t(1) << (ch & 63);
+    }
+
+    /**
+     * @brief Add all ASCII characters satisfying `pred`.
+     */
+    template <typename Pred>
+    constexpr void add_if(Pred pred) {
+        for (int ch = 0; ch < 128; ++ch)
+            if (pred(char(ch))) add((unsigned char)ch);
+    }
+
+    /**
+     * @brief Replace the set by its complement.
+     */
+    constexpr void invert() noexcept {
+        for (auto &word : bits) word = ~word;
+    }
+
+    /**
+     * @brief Check whether the set contains `ch`.
+     */
+    constexpr bool contains(char ch) const noexcept {
+        auto byte = (unsigned char)ch;
+        return (bits[byte >> 6] >> (byte & 63)) & 1;
+    }
+};
+
+/**
+ * @brief Wildcard pattern compiled at compile time.
+ * @details
+ * The syntax follows `fnmatch` without flags:
+ * - `*` matches any sequence of characters, including `/`;
+ * - `?` matches any single character;
+ * - `[abc]`, `[a-z]` and `[!a-z]` or `[^a-z]` match one character of a class,
+ *   which may contain `[:alpha:]`, `[:digit:]`, `[:alnum:]`, `[:xdigit:]`,
+ *   `[:lower:]`, `[:upper:]`, `[:space:]`, `[:blank:]`, `[:punct:]`,
+ *   `[:cntrl:]`, `[:graph:]` and `[:print:]`, built from `charutils`;
+ * - `\` escapes the next character.
+ *
+ * The pattern is split at `*` into segments. Literal segments are searched
+ * with `std::string_view::find`, and every segment between two `*` is
+ * matched at its leftmost position, so matching never backtracks and takes
+ * at most O(pattern length * input length) time.
+ * @tparam Pattern wildcard pattern
+ * @see glob
+ */
+template <cstr Pattern>
+class glob_pattern {
+    enum class kind : std::uint8_t { literal, any, set };
+
+    struct atom {
+        kind type = kind::literal;
+        std::size_t set = 0;
+    };
+
+    static constexpr std::size_t N = Pattern.size();
+
+    struct parsed {
+        std::array<atom, N + 1> atoms{};
+        std::array<char, N + 1> text{};
+        std::array<char_set, N + 1> sets{};
+        std::array<std::size_t, N + 2> bounds{};
+        std::array<bool, N + 1> literal{};
+        std::size_t segments = 0;
+        std::size_t length = 0;
+        std::size_t set_count = 0;
+    };
+
+    static consteval bool add_class(char_set &set, std::string_view name) {
+        struct named_class {
+            std::string_view name;
+            bool (*pred)(char);
+        };
+        constexpr named_class classes[] = {
+            {"alpha", charutils::isalpha<char>},
+            {"digit", charutils::isdigit<char>},
+            {"alnum", charutils::isalnum<char>},
+            {"xdigit", charutils::isxdigit<char>},
+            {"lower", charutils::islower<char>},
+            {"upper", charutils::issuper<char>},
+            {"space", charutils::isspace<char>},
+            {"blank", charutils::isblank<char>},
+            {"punct", charutils::ispunct<char>},
+            {"cntrl", charutils::iscntrl<char>},
+            {"graph", charutils::isgraph<char>},
+            {"print", charutils::isprint<char>},
+        };
+        for (const auto &c : classes) {
+            if (c.name == name) {
+                set.add_if(c.pred);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static consteval std::size_t parse_set(parsed &p, std::size_t i) {
+        const std::string_view pattern = Pattern;
+        char_set &set = p.sets[p.set_count];
+        bool negate = i < N && (pattern[i] == '!' || pattern[i] == '^');
+        if (negate) ++i;
+        for (bool first = true;; first = false) {
+            if (i >= N) throw "glob: unterminated '['";
+            char ch = pattern[i];
+            if (ch == ']' && !first) break;
+            if (ch == '[' && i + 1 < N && pattern[i + 1] == ':') {
+                std::size_t end = pattern.find(":]", i + 2);
+                if (end == pattern.npos) throw "glob: unterminated '[:'";
+                if (!add_class(set, pattern.substr(i + 2, end - i - 2)))
+                    throw "glob: unknown character class";
+                i = end + 2;
+                continue;
+            }
+            if (ch == '\\' && ++i >= N) throw "glob: trailing '\\'";
+            char low = pattern[i++];
+            char high = low;
+            if (i + 1 < N && pattern[i] == '-' && pattern[i + 1] != ']') {
+                high = pattern[i + 1] == '\\' && i + 2 < N ? pattern[i + 2]
+                                                           : pattern[i + 1];
+                i += pattern[i + 1] == '\\' ? 3 : 2;
+            }
+            for (int c = (unsigned char)low; c <= (unsigned char)high; ++c)
+                set.add((unsigned char)c);
+        }
+        if (negate) set.invert();
+        ++p.set_count;
+        return i + 1;
+    }
+
+    static consteval parsed parse() {
+        const std::string_view pattern = Pattern;
+        parsed p;
+        auto close_segment = [&] {
+            p.bounds[++p.segments] = p.length;
+        };
+        for (std::size_t i = 0; i < N;) {
+            char ch = pattern[i];
+            if (ch == '*') {
+                close_segment();
+                while (i < N && pattern[i] == '*') ++i;
+                continue;
+            }
+            atom &a = p.atoms[p.length];
+            if (ch == '?') {
+                a.type = kind::any;
+                ++i;
+            } else if (ch == '[') {
+                a.type = kind::set;
+                a.set = p.set_count;
+                i = parse_set(p, i + 1);
+            } else {
+                if (ch == '\\' && ++i >= N) throw "glob: trailing '\\'";
+                a.type = kind::literal;
+                p.text[p.length] = pattern[i++];
+            }
+            ++p.length;
+        }
+        close_segment();
+        for (std::size_t s = 0; s < p.segments; ++s) {
+            p.literal[s] = true;
+            for (std::size_t j = p.bounds[s]; j < p.bounds[s + 1]; ++j)
+                if (p.atoms[j].type != kind::literal) p.literal[s] = false;
+        }
+        return p;
+    }
+
+    static constexpr parsed _p = parse();
+
+    static constexpr std::size_t size_of(std::size_t s) noexcept {
+        return _p.bounds[s + 1] - _p.bounds[s];
+    }
+
+    static constexpr bool match_at(std::size_t s, std::string_view input,
+                                   std::size_t pos) noexcept {
+        for (std::size_t j = _p.bounds[s], k = pos; j < _p.bounds[s + 1];
+             ++j, ++k) {
+            const atom &a = _p.atoms[j];
+            if (a.type == kind::literal && input[k] != _p.text[j])
+                return false;
+            if (a.type == kind::set && !_p.sets[a.set].contains(input[k]))
+                return false;
+        }
+        return true;
+    }
+
+    static constexpr std::size_t find(std::size_t s, std::string_view input,
+                                      std::size_t from,
+                                      std::size_t last) noexcept {
+        if (_p.literal[s]) {
+            std::string_view text(_p.text.data() + _p.bounds[s], size_of(s));
+            return input.substr(0, last + text.size()).find(text, from);
+        }
+        for (std::size_t pos = from; pos <= last; ++pos)
+            if (match_at(s, input, pos)) return pos;
+        return std::string_view::npos;
+    }
+
+   public:
+    /**
+     * @brief Number of segments separated by `*`.
+     */
+    static constexpr std::size_t segments = _p.segments;
+
+    /**
+     * @brief Check whether the whole `input` matches the pattern.
+     */
+    static constexpr bool match(std::string_view input) noexcept {
+        constexpr std::size_t last = segments - 1;
+        if constexpr (segments == 1) {
+            return input.size() == size_of(0) && match_at(0, input, 0);
+        } else {
+            std::size_t head = size_of(0), tail = size_of(last);
+            if (input.size() < head + tail) return false;
+            if (!match_at(0, input, 0) ||
+                !match_at(last, input, input.size() - tail))
+                return false;
+            std::size_t pos = head;
+            const std::size_t end = input.size() - tail;
+            for (std::size_t s = 1; s < last; ++s) {
+                if (end - pos < size_of(s)) return false;
+                std::size_t found = find(s, input, pos, end - size_of(s));
+                if (found == std::string_view::npos) return false;
+                pos = found + size_of(s);
+            }
+            return true;
+        }
+    }
+
+    /**
+     * @brief Same as `match`.
+     */
+    constexpr bool operator()(std::string_view input) const noexcept {
+        return match(input);
+    }
+};
+
+/**
+ * @brief Compiled wildcard pattern, for example
+ * `conststr::glob<"*.log.[0-9]"_cs>("app.log.1")` is `true`.
+ * @tparam Pattern wildcard pattern, see `glob_pattern` for its syntax
+ */
+template <cstr Pattern>
+constexpr glob_pattern<Pattern> glob{};
+}  // namespace conststr
+
+#endif
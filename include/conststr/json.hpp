@@ -0,0 +1,704 @@
+/* MIT License
+ *
+ * Copyright (c) 2024 Nichts Hsu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * @file json.hpp
+ * @brief JSON literals parsed at compile time.
+ */
+
+#ifndef CONSTSTR_JSON_HPP
+#define CONSTSTR_JSON_HPP
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+
+#include "../conststr.hpp"
+
+namespace conststr {
+/**
+ * @brief JSON documents parsed at compile time into a tape.
+ * @details
+ * A document is stored as an array of `json::node` in document order, plus
+ * a pool of unescaped string bytes. Arrays and objects record the distance
+ * to the node past their last descendant, so skipping a whole subtree is
+ * O(1). Both arrays are `static constexpr`, so they end up in read-only data
+ * and need no parsing at runtime. Numbers are rounded to the nearest double.
+ */
+namespace json {
+/**
+ * @brief Type of a JSON value.
+ */
+enum class type : std::uint8_t {
+    missing,  // result of looking up an absent key or index
+    null,
+    boolean,
+    number,
+    string,
+    array,
+    object,
+};
+
+/**
+ * @brief Entry of the tape.
+ * @details
+ * For strings `offset` and `size` locate the bytes in the string pool. For
+ * arrays and objects `size` is the number of elements or members and `end`
+ * the distance to the node past the last descendant; object members are
+ * stored as a string node for the key followed by the value.
+ */
+struct node {
+    json::type type = json::type::null;
+    bool integral = false;
+    std::uint32_t size = 0;
+    std::uint32_t offset = 0;
+    std::uint32_t end = 0;
+    double number = 0;
+    std::int64_t integer = 0;
+};
+
+/**
+ * @brief Internal implementation of `json`.
+ * Unsigned integer of up to 4096 bits, for correctly rounded numbers.
+ */
+struct bigint {
+    std::array<std::uint32_t, 128> word{};
+    std::size_t size = 0;  // number of words in use, the top one is non-zero
+
+    constexpr void trim() {
+        while (size != 0 && word[size - 1] == 0) --size;
+    }
+
+    constexpr std::size_t bit_width() const {
+        return size == 0 ? 0
+                         : 32 * (size - 1) + std::bit_width(word[size - 1]);
+    }
+
+    constexpr void mul_add(std::uint32_t factor, std::uint32_t addend) {
+        std::uint64_t carry = addend;
+        for (std::size_t i = 0; i < size; ++i) {
+            carry += std::uint64_t(word[i]) * factor;
+            word[i] = std::uint32_t(carry);
+            carry >>= 32;
+        }
+        if (carry != 0) word[size++] = std::uint32_t(carry);
+    }
+
+    constexpr void mul_pow10(std::size_t exp) {
+        for (; exp >= 9; exp -= 9) mul_add(1000000000, 0);
+        std::uint32_t factor = 1;
+        for (; exp > 0; --exp) factor *= 10;
+        mul_add(factor, 0);
+    }
+
+    constexpr void shift_left(std::size_t bits) {
+        if (size == 0) return;
+        std::size_t words = bits / 32, rest = bits % 32;
+        std::array<std::uint32_t, 128> out{};
+        for (std::size_t i = 0; i < size; ++i) {
+            out[i + words] |= word[i] << rest;
+            if (rest != 0) out[i + words + 1] |= word[i] >> (32 - rest);
+        }
+        word = out;
+        size += words + 1;
+        trim();
+    }
+
+    constexpr void shift_right_one() {
+        for (std::size_t i = 0; i < size; ++i)
+            word[i] = (word[i] >> 1) |
+                      (i + 1 < size ? word[i + 1] << 31 : std::uint32_t(0));
+        trim();
+    }
+
+    constexpr bool operator>=(const bigint &other) const {
+        if (size != other.size) return size > other.size;
+        for (std::size_t i = size; i-- > 0;)
+            if (word[i] != other.word[i]) return word[i] > other.word[i];
+        return true;
+    }
+
+    constexpr void operator-=(const bigint &other) {
+        std::uint64_t borrow = 0;
+        for (std::size_t i = 0; i < size; ++i) {
+            std::uint64_t rhs = (i < other.size ? other.word[i] : 0) + borrow;
+            borrow = word[i] < rhs;
+            word[i] = std::uint32_t(word[i] - rhs);
+        }
+        trim();
+    }
+};
+
+/**
+ * @brief Internal implementation of `json`.
+ * Round `num / den` to the nearest double, ties to even.
+ */
+constexpr double round_ratio(bigint num, bigint den) {
+    // Scale so that the quotient lies in [2^62, 2^64).
+    std::int64_t shift = 63 - (std::int64_t(num.bit_width()) -
+                               std::int64_t(den.bit_width()));
+    if (shift >= 0)
+        num.shift_left(std::size_t(shift));
+    else
+        den.shift_left(std::size_t(-shift));
+    std::uint64_t q = 0;
+    den.shift_left(63);
+    for (int i = 63; i >= 0; --i) {
+        if (num >= den) {
+            num -= den;
+            q |= std::uint64_t(1) << i;
+        }
+        den.shift_right_one();
+    }
+    bool inexact = num.size != 0;
+
+    // The value is q * 2^-shift, keep 53 bits or fewer if it is subnormal.
+    std::int64_t width = std::bit_width(q);
+    std::int64_t exp = width - 1 - shift;
+    if (exp > 1023) return std::numeric_limits<double>::infinity();
+    std::int64_t drop = exp >= -1022 ? width - 53 : width - 1075 - exp;
+    if (drop > 64) return 0;
+    std::uint64_t kept = drop == 64 ? 0 : q >> drop;
+    std::uint64_t rest = drop == 64 ? q : q & ((std::uint64_t(1) << drop) - 1);
+    std::uint64_t half = std::uint64_t(1) << (drop - 1);
+    if (rest > half || (rest == half && (inexact || (kept & 1)))) ++kept;
+    if (exp < -1022) return std::bit_cast<double>(kept);
+    if (kept == std::uint64_t(1) << 53) {
+        kept >>= 1;
+        ++exp;
+    }
+    if (exp > 1023) return std::numeric_limits<double>::infinity();
+    return std::bit_cast<double>(std::uint64_t(exp + 1023) << 52 |
+                                 (kept & ((std::uint64_t(1) << 52) - 1)));
+}
+
+/**
+ * @brief Internal implementation of `json`.
+ * Convert the digits of a JSON number to the nearest double.
+ * @param integer digits before the decimal point
+ * @param fraction digits after the decimal point
+ * @param exp10 decimal exponent
+ */
+constexpr double to_double(std::string_view integer, std::string_view fraction,
+                           std::int64_t exp10) {
+    std::size_t total = integer.size() + fraction.size();
+    auto digit_at = [&](std::size_t i) -> std::uint32_t {
+        return std::uint32_t(
+            (i < integer.size() ? integer[i] : fraction[i - integer.size()]) -
+            '0');
+    };
+    std::size_t first = 0, last = total;
+    while (first < total && digit_at(first) == 0) ++first;
+    if (first == total) return 0;
+    while (digit_at(last - 1) == 0) --last;
+    // The value is digits [first, last) times 10^exp.
+    std::size_t count = last - first;
+    std::int64_t exp = exp10 + std::int64_t(integer.size()) -
+                       std::int64_t(last);
+    if (exp + std::int64_t(count) > 310)
+        return std::numeric_limits<double>::infinity();
+    if (exp + std::int64_t(count) < -323) return 0;
+
+    // Clinger's fast path: both operands and the result are exact doubles.
+    if (count <= 15 && exp >= -22 && exp <= 22) {
+        double mantissa = 0, scale = 1;
+        for (std::size_t i = first; i < last; ++i)
+            mantissa = mantissa * 10 + digit_at(i);
+        for (std::int64_t e = exp < 0 ? -exp : exp; e > 0; --e) scale *= 10;
+        return exp < 0 ? mantissa / scale : mantissa * scale;
+    }
+
+    // Otherwise divide big integers exactly. 768 digits decide the rounding
+    // of any double, a trailing 1 stands for the digits beyond them.
+    constexpr std::size_t max_digits = 768;
+    bigint num, den;
+    std::size_t used = count < max_digits ? count : max_digits;
+    for (std::size_t i = first; i < first + used; ++i)
+        num.mul_add(10, digit_at(i));
+    exp += std::int64_t(count - used);
+    if (used < count) {
+        num.mul_add(10, 1);
+        --exp;
+    }
+    den.mul_add(1, 1);
+    if (exp >= 0)
+        num.mul_pow10(std::size_t(exp));
+    else
+        den.mul_pow10(std::size_t(-exp));
+    return round_ratio(num, den);
+}
+
+/**
+ * @brief Internal implementation of `json`.
+ * Recursive-descent parser, counting only if `tape` is `nullptr`.
+ */
+struct parser {
+    std::string_view src;
+    node *tape = nullptr;
+    char *pool = nullptr;
+    std::size_t pos = 0;
+    std::size_t nodes = 0;
+    std::size_t chars = 0;
+
+    [[noreturn]] static void fail(const char *msg) { throw msg; }
+
+    constexpr void skip_ws() {
+        while (pos < src.size() && (src[pos] == ' ' || src[pos] == '\t' ||
+                                    src[pos] == '\n' || src[pos] == '\r'))
+            ++pos;
+    }
+
+    constexpr char peek() {
+        skip_ws();
+        if (pos >= src.size()) fail("json: unexpected end");
+        return src[pos];
+    }
+
+    constexpr void expect(char ch) {
+        if (peek() != ch) fail("json: unexpected character");
+        ++pos;
+    }
+
+    constexpr void literal(std::string_view word) {
+        if (src.substr(pos, word.size()) != word) fail("json: invalid literal");
+        pos += word.size();
+    }
+
+    constexpr std::size_t push(json::type t) {
+        if (tape) tape[nodes].type = t;
+        return nodes++;
+    }
+
+    constexpr void put(char ch) {
+        if (pool) pool[chars] = ch;
+        ++chars;
+    }
+
+    constexpr void put_utf8(std::uint32_t cp) {
+        if (cp < 0x80) {
+            put(char(cp));
+        } else if (cp < 0x800) {
+            put(char(0xC0 | (cp >> 6)));
+            put(char(0x80 | (cp & 0x3F)));
+        } else if (cp < 0x10000) {
+            put(char(0xE0 | (cp >> 12)));
+            put(char(0x80 | ((cp >> 6) & 0x3F)));
+            put(char(0x80 | (cp & 0x3F)));
+        } else {
+            put(char(0xF0 | (cp >> 18)));
+            put(char(0x80 | ((cp >> 12) & 0x3F)));
+            put(char(0x80 | ((cp >> 6) & 0x3F)));
+            put(char(0x80 | (cp & 0x3F)));
+        }
+    }
+
+    constexpr std::uint32_t hex4() {
+        if (pos + 4 > src.size()) fail("json: truncated escape");
+        std::uint32_t value = 0;
+        for (int i = 0; i < 4; ++i) {
+            char ch = src[pos++];
+            value <<= 4;
+            if (ch >= '0' && ch <= '9')
+                value |= std::uint32_t(ch - '0');
+            else if (ch >= 'a' && ch <= 'f')
+                value |= std::uint32_t(ch - 'a' + 10);
+            else if (ch >= 'A' && ch <= 'F')
+                value |= std::uint32_t(ch - 'A' + 10);
+            else
+                fail("json: invalid escape");
+        }
+        return value;
+    }
+
+    constexpr void string() {
+        expect('"');
+        std::size_t index = push(json::type::string);
+        std::size_t start = chars;
+        while (true) {
+            if (pos >= src.size()) fail("json: unterminated string");
+            char ch = src[pos++];
+            if (ch == '"') break;
+            if ((unsigned char)ch < 0x20) fail("json: control character");
+            if (ch != '\\') {
+                put(ch);
+                continue;
+            }
+            if (pos >= src.size()) fail("json: unterminated string");
+            switch (src[pos++]) {
+                case '"': put('"'); break;
+                case '\\': put('\\'); break;
+                case '/': put('/'); break;
+                case 'b': put('\b'); break;
+                case 'f': put('\f'); break;
+                case 'n': put('\n'); break;
+                case 'r': put('\r'); break;
+                case 't': put('\t'); break;
+                case 'u': {
+                    std::uint32_t cp = hex4();
+                    if (cp >= 0xD800 && cp < 0xDC00) {
+                        literal("\\u");
+                        std::uint32_t low = hex4();
+                        if (low < 0xDC00 || low >= 0xE000)
+                            fail("json: invalid surrogate pair");
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                    } else if (cp >= 0xDC00 && cp < 0xE000) {
+                        fail("json: unpaired low surrogate");
+                    }
+                    put_utf8(cp);
+                    break;
+                }
+                default: fail("json: invalid escape");
+            }
+        }
+        if (tape) {
+            tape[index].offset = std::uint32_t(start);
+            tape[index].size = std::uint32_t(chars - start);
+        }
+    }
+
+    constexpr void number() {
+        std::size_t index = push(json::type::number);
+        bool negative = src[pos] == '-';
+        if (negative) ++pos;
+        auto digit = [&] {
+            return pos < src.size() && src[pos] >= '0' && src[pos] <= '9';
+        };
+        auto digits = [&] {
+            if (!digit()) fail("json: invalid number");
+            std::size_t start = pos;
+            while (digit()) ++pos;
+            return src.substr(start, pos - start);
+        };
+        if (pos + 1 < src.size() && src[pos] == '0' && src[pos + 1] >= '0' &&
+            src[pos + 1] <= '9')
+            fail("json: leading zero");
+        std::string_view integer = digits(), fraction;
+        if (pos < src.size() && src[pos] == '.') {
+            ++pos;
+            fraction = digits();
+        }
+        std::int64_t exp = 0;
+        bool has_exp = pos < src.size() && (src[pos] == 'e' || src[pos] == 'E');
+        if (has_exp) {
+            ++pos;
+            bool negative_exp = false;
+            if (pos < src.size() && (src[pos] == '+' || src[pos] == '-'))
+                negative_exp = src[pos++] == '-';
+            // Larger exponents overflow or underflow anyway.
+            for (char ch : digits())
+                if (exp < 1000000000) exp = exp * 10 + (ch - '0');
+            if (negative_exp) exp = -exp;
+        }
+        if (!tape) return;
+        node &n = tape[index];
+        n.number = to_double(integer, fraction, exp);
+        if (negative) n.number = -n.number;
+        if (fraction.empty() && !has_exp && integer.size() <= 19) {
+            std::uint64_t mantissa = 0;
+            for (char ch : integer)
+                mantissa = mantissa * 10 + std::uint64_t(ch - '0');
+            constexpr auto max =
+                std::uint64_t(std::numeric_limits<std::int64_t>::max());
+            if (mantissa <= max) {
+                n.integral = true;
+                n.integer = negative ? -std::int64_t(mantissa)
+                                     : std::int64_t(mantissa);
+            } else if (negative && mantissa == max + 1) {
+                n.integral = true;
+                n.integer = std::numeric_limits<std::int64_t>::min();
+            }
+        }
+    }
+
+    constexpr void value() {
+        switch (peek()) {
+            case '{': {
+                ++pos;
+                std::size_t index = push(json::type::object);
+                std::uint32_t count = 0;
+                if (peek() != '}') {
+                    while (true) {
+                        string();
+                        expect(':');
+                        value();
+                        ++count;
+                        if (peek() != ',') break;
+                        ++pos;
+                    }
+                }
+                expect('}');
+                if (tape) {
+                    tape[index].size = count;
+                    tape[index].end = std::uint32_t(nodes - index);
+                }
+                break;
+            }
+            case '[': {
+                ++pos;
+                std::size_t index = push(json::type::array);
+                std::uint32_t count = 0;
+                if (peek() != ']') {
+                    while (true) {
+                        value();
+                        ++count;
+                        if (peek() != ',') break;
+                        ++pos;
+                    }
+                }
+                expect(']');
+                if (tape) {
+                    tape[index].size = count;
+                    tape[index].end = std::uint32_t(nodes - index);
+                }
+                break;
+            }
+            case '"':
+                string();
+                break;
+            case 't':
+                literal("true");
+                if (std::size_t index = push(json::type::boolean); tape)
+                    tape[index].integral = true;
+                break;
+            case 'f':
+                literal("false");
+                push(json::type::boolean);
+                break;
+            case 'n':
+                literal("null");
+                push(json::type::null);
+                break;
+            default:
+                number();
+        }
+    }
+
+    constexpr void document() {
+        value();
+        skip_ws();
+        if (pos != src.size()) fail("json: trailing characters");
+    }
+};
+
+/**
+ * @brief Immutable view of a value in a parsed JSON document.
+ * @details
+ * Looking up an absent key or index gives a value of type `missing`, which
+ * converts to `false`; all accessors of such a value return their default.
+ */
+class value {
+   public:
+    constexpr value() noexcept = default;
+    constexpr value(const node *tape, const char *pool) noexcept
+        : _node(tape), _pool(pool) {}
+
+    /**
+     * @brief Get the type of the value.
+     */
+    constexpr json::type type() const noexcept {
+        return _node ? _node->type : json::type::missing;
+    }
+
+    /**
+     * @brief Check whether the value exists.
+     */
+    constexpr explicit operator bool() const noexcept { return _node; }
+
+    constexpr bool is_null() const noexcept {
+        return type() == json::type::null;
+    }
+    constexpr bool is_bool() const noexcept {
+        return type() == json::type::boolean;
+    }
+    constexpr bool is_number() const noexcept {
+        return type() == json::type::number;
+    }
+    constexpr bool is_integer() const noexcept {
+        return is_number() && _node->integral;
+    }
+    constexpr bool is_string() const noexcept {
+        return type() == json::type::string;
+    }
+    constexpr bool is_array() const noexcept {
+        return type() == json::type::array;
+    }
+    constexpr bool is_object() const noexcept {
+        return type() == json::type::object;
+    }
+
+    /**
+     * @brief Get the boolean, or `fallback` if the value is not a boolean.
+     */
+    constexpr bool as_bool(bool fallback = false) const noexcept {
+        return is_bool() ? _node->integral : fallback;
+    }
+
+    /**
+     * @brief Get the integer, or `fallback` if the value is not an integer.
+     */
+    constexpr std::int64_t as_int(std::int64_t fallback = 0) const noexcept {
+        return is_integer() ? _node->integer : fallback;
+    }
+
+    /**
+     * @brief Get the number, or `fallback` if the value is not a number.
+     */
+    constexpr double as_double(double fallback = 0) const noexcept {
+        return is_number() ? _node->number : fallback;
+    }
+
+    /**
+     * @brief Get the string, or `fallback` if the value is not a string.
+     */
+    constexpr std::string_view as_string(
+        std::string_view fallback = {}) const noexcept {
+        return is_string() ? std::string_view(_pool + _node->offset,
+                                              _node->size)
+                           : fallback;
+    }
+
+    /**
+     * @brief Get the number of elements of an array or members of an object.
+     */
+    constexpr std::size_t size() const noexcept {
+        return is_array() || is_object() ? _node->size : 0;
+    }
+
+    /**
+     * @brief Get the element at `index` of an array.
+     */
+    constexpr value operator[](std::size_t index) const noexcept {
+        if (!is_array() || index >= _node->size) return {};
+        const node *child = _node + 1;
+        for (; index > 0; --index) child = next(child);
+        return {child, _pool};
+    }
+
+    /**
+     * @brief Get the member `key` of an object.
+     */
+    constexpr value operator[](std::string_view key) const noexcept {
+        if (!is_object()) return {};
+        const node *child = _node + 1;
+        for (std::size_t i = 0; i < _node->size; ++i) {
+            if (value(child, _pool).as_string() == key)
+                return {child + 1, _pool};
+            child = next(child + 1);
+        }
+        return {};
+    }
+
+    /**
+     * @brief Check whether an object has the member `key`.
+     */
+    constexpr bool contains(std::string_view key) const noexcept {
+        return bool((*this)[key]);
+    }
+
+    /**
+     * @brief Call `f(element)` for each element of an array, or
+     * `f(key, value)` for each member of an object.
+     */
+    template <typename F>
+    constexpr void for_each(F &&f) const {
+        const node *child = _node + 1;
+        for (std::size_t i = 0; i < size(); ++i) {
+            if constexpr (std::is_invocable_v<F &, value>) {
+                if (!is_array()) return;
+                f(value(child, _pool));
+                child = next(child);
+            } else {
+                if (!is_object()) return;
+                f(value(child, _pool).as_string(), value(child + 1, _pool));
+                child = next(child + 1);
+            }
+        }
+    }
+
+   private:
+    static constexpr const node *next(const node *n) noexcept {
+        return n->type == json::type::array || n->type == json::type::object
+                   ? n + n->end
+                   : n + 1;
+    }
+
+    const node *_node = nullptr;
+    const char *_pool = nullptr;
+};
+
+/**
+ * @brief Tape and string pool of the JSON document `Src`.
+ * @tparam Src JSON text.
+ */
+template <cstr Src>
+    requires std::same_as<typename decltype(Src)::value_type, char>
+struct document {
+   private:
+    static constexpr parser counted = [] {
+        parser p{std::string_view(Src)};
+        p.document();
+        return p;
+    }();
+
+    struct storage {
+        std::array<node, counted.nodes> tape;
+        std::array<char, counted.chars> pool;
+    };
+
+    static constexpr storage data = [] {
+        storage s{};
+        parser p{std::string_view(Src), s.tape.data(), s.pool.data()};
+        p.document();
+        return s;
+    }();
+
+   public:
+    /**
+     * @brief Root value of the document.
+     */
+    static constexpr json::value root{data.tape.data(), data.pool.data()};
+};
+}  // namespace json
+
+namespace literal {
+/**
+ * @brief Parse a JSON literal at compile time.
+ * @details
+ * Malformed JSON is a compile error. The returned value refers to static
+ * read-only storage and can be copied freely.
+ * @code
+ * constexpr auto cfg = R"({"port": 8080})"_json;
+ * static_assert(cfg["port"].as_int() == 8080);
+ * @endcode
+ */
+template <cstr str>
+consteval json::value operator""_json() {
+    return json::document<str>::root;
+}
+}  // namespace literal
+}  // namespace conststr
+
+#endif  // CONSTSTR_JSON_HPP
@@ -0,0 +1,341 @@
+/* MIT License
+ *
+ * Copyright (c) 2024 Nichts Hsu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * @file router.hpp
+ * @brief URL route table compiled at compile time.
+ */
+
+#ifndef CONSTSTR_ROUTER_HPP
+#define CONSTSTR_ROUTER_HPP
+
+#include <algorithm>
+#include <array>
+#include <optional>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "../conststr.hpp"
+
+namespace conststr {
+/**
+ * @brief Internal implementation of `router`.
+ * Whether a path segment is a parameter like `{id}`.
+ */
+constexpr bool is_route_param(std::string_view segment) noexcept {
+    return segment.size() >= 2 && segment.front() == '{' &&
+           segment.back() == '}';
+}
+
+/**
+ * @brief Internal implementation of `router`.
+ * Call `f(segment)` for each `/`-separated segment of `path` after its
+ * leading `/`. The path `/` has no segment.
+ */
+template <typename F>
+constexpr void for_each_segment(std::string_view path, F f) {
+    path.remove_prefix(1);
+    if (path.empty()) return;
+    while (true) {
+        std::size_t slash = path.find('/');
+        f(path.substr(0, slash));
+        if (slash == path.npos) return;
+        path.remove_prefix(slash + 1);
+    }
+}
+
+/**
+ * @brief Parameters captured by the route `Path`.
+ * @details
+ * Access them by name, for example `params.get<"id">()` for the route
+ * `/users/{id}`, or by index in the order they appear in the route.
+ * @tparam Path route template
+ * @tparam Capacity size of the capture array
+ */
+template <cstr Path, std::size_t Capacity>
+struct route_params {
+    /**
+     * @brief Number of parameters in `Path`.
+     */
+    static constexpr std::size_t size = [] {
+        std::size_t count = 0;
+        for_each_segment(Path, [&](std::string_view segment) {
+            count += is_route_param(segment);
+        });
+        return count;
+    }();
+
+    /**
+     * @brief Index of the parameter `Name`, or `size` if there is none.
+     */
+    template <cstr Name>
+    static constexpr std::size_t index_of = [] {
+        std::size_t index = 0, found = size;
+        for_each_segment(Path, [&](std::string_view segment) {
+            if (!is_route_param(segment)) return;
+            if (segment.substr(1, segment.size() - 2) == Name) found = index;
+            ++index;
+        });
+        return found;
+    }();
+
+    /**
+     * @brief Captured values, valid as long as the matched path.
+     */
+    std::array<std::string_view, Capacity> values;
+
+    /**
+     * @brief Get the parameter `Name`.
+     */
+    template <cstr Name>
+    constexpr std::string_view get() const noexcept
+        requires std::same_as<typename decltype(Name)::value_type, char>
+    {
+        static_assert(index_of<Name> < size, "no such route parameter");
+        return values[index_of<Name>];
+    }
+
+    /**
+     * @brief Get the i-th parameter.
+     */
+    constexpr std::string_view operator[](std::size_t i) const noexcept {
+        return values[i];
+    }
+};
+
+/**
+ * @brief Route of `router`.
+ * @tparam Path route template, `/`-separated, where a whole segment like
+ * `{name}` captures one segment of the path
+ * @tparam Handler default-constructible callable type, invoked with
+ * `route_params` and the extra arguments of `router::dispatch`
+ */
+template <cstr Path, typename Handler = void>
+struct route {
+    static_assert(Path.size() > 0 && Path[0] == '/',
+                  "route must start with '/'");
+    static constexpr auto path = Path;
+    using handler = Handler;
+};
+
+/**
+ * @brief URL route table compiled into a segment tree at compile time.
+ * @details
+ * All routes are split on `/` and merged into one tree, where the static
+ * segments shared by several routes are stored once. Matching walks the tree
+ * over the path segment by segment, preferring a static segment over a
+ * parameter; it falls back to the parameter only where both exist at the
+ * same position. Parameters never match an empty segment. Captures are
+ * stored in a fixed-size array of `std::string_view` into the path, so
+ * matching does not allocate.
+ * For example:
+ * @code{.cpp}
+ * using routes = conststr::router<
+ *     conststr::route<"/users/{id}"_cs, get_user>,
+ *     conststr::route<"/users/{id}/posts/{pid}"_cs, get_post>>;
+ * auto response = routes::dispatch(path, request);
+ * @endcode
+ * @note The path is compared as-is, strip any query string before matching.
+ * @tparam Routes list of `route`
+ */
+template <typename... Routes>
+class router {
+   public:
+    /**
+     * @brief Value of `match::index` if no route matches.
+     */
+    static constexpr std::size_t npos = std::size_t(-1);
+
+    /**
+     * @brief Number of routes.
+     */
+    static constexpr std::size_t size = sizeof...(Routes);
+
+    /**
+     * @brief Largest number of parameters of any route.
+     */
+    static constexpr std::size_t max_captures =
+        std::max({std::size_t(0), route_params<Routes::path, 0>::size...});
+
+    /**
+     * @brief Result of `match`.
+     */
+    struct match_result {
+        /**
+         * @brief Index of the matched route, or `npos`.
+         */
+        std::size_t index = npos;
+
+        /**
+         * @brief Captured parameters of the matched route, in route order.
+         */
+        std::array<std::string_view, max_captures> captures{};
+
+        constexpr explicit operator bool() const noexcept {
+            return index != npos;
+        }
+    };
+
+   private:
+    struct node {
+        std::string_view segment;
+        std::size_t first_child = npos;
+        std::size_t next_sibling = npos;
+        std::size_t param_child = npos;
+        std::size_t route = npos;
+    };
+
+    static constexpr std::size_t max_nodes = [] {
+        std::size_t count = 1;
+        (for_each_segment(Routes::path, [&](std::string_view) { ++count; }),
+         ...);
+        return count;
+    }();
+
+    struct tree {
+        std::array<node, max_nodes> nodes{};
+        std::size_t size = 1;
+    };
+
+    static consteval tree build() {
+        tree t;
+        std::string_view paths[] = {std::string_view(Routes::path)...};
+        for (std::size_t r = 0; r < size; ++r) {
+            std::size_t current = 0;
+            for_each_segment(paths[r], [&](std::string_view segment) {
+                node &parent = t.nodes[current];
+                if (is_route_param(segment)) {
+                    if (parent.param_child == npos)
+                        parent.param_child = t.size++;
+                    current = parent.param_child;
+                    return;
+                }
+                std::size_t *link = &parent.first_child;
+                while (*link != npos && t.nodes[*link].segment != segment)
+                    link = &t.nodes[*link].next_sibling;
+                if (*link == npos) {
+                    *link = t.size++;
+                    t.nodes[*link].segment = segment;
+                }
+                current = *link;
+            });
+            if (t.nodes[current].route != npos)
+                throw "router: duplicate route";
+            t.nodes[current].route = r;
+        }
+        return t;
+    }
+
+    static constexpr tree _tree = build();
+
+    static constexpr std::size_t walk(std::size_t current,
+                                      std::string_view rest, bool done,
+                                      match_result &result,
+                                      std::size_t depth) noexcept {
+        const node &n = _tree.nodes[current];
+        if (done) return n.route;
+        std::size_t slash = rest.find('/');
+        std::string_view segment = rest.substr(0, slash);
+        bool last = slash == rest.npos;
+        std::string_view next =
+            last ? std::string_view() : rest.substr(slash + 1);
+        for (std::size_t child = n.first_child; child != npos;
+             child = _tree.nodes[child].next_sibling) {
+            if (_tree.nodes[child].segment != segment) continue;
+            std::size_t found = walk(child, next, last, result, depth);
+            if (found != npos) return found;
+            break;
+        }
+        if (n.param_child != npos && !segment.empty()) {
+            std::size_t found =
+                walk(n.param_child, next, last, result, depth + 1);
+            if (found != npos) {
+                result.captures[depth] = segment;
+                return found;
+            }
+        }
+        return npos;
+    }
+
+    template <std::size_t I, typename... Args>
+    static decltype(auto) invoke(const match_result &result, Args &&...args) {
+        using route_t = std::tuple_element_t<I, std::tuple<Routes...>>;
+        using params_t = route_params<route_t::path, max_captures>;
+        return typename route_t::handler{}(params_t{result.captures},
+                                           std::forward<Args>(args)...);
+    }
+
+   public:
+    /**
+     * @brief Find the route matching `path`.
+     * @param path path starting with `/`
+     * @return Index and captures of the matched route, which converts to
+     * `false` if no route matches.
+     */
+    static constexpr match_result match(std::string_view path) noexcept {
+        match_result result;
+        if (path.empty() || path[0] != '/') return result;
+        path.remove_prefix(1);
+        result.index = walk(0, path, path.empty(), result, 0);
+        return result;
+    }
+
+    /**
+     * @brief Match `path` and call the handler of the matched route.
+     * @param path path starting with `/`
+     * @param args extra arguments passed to the handler
+     * @return `false` if no route matches and `true` otherwise if handlers
+     * return `void`, otherwise `std::optional` of the handler result.
+     */
+    template <typename... Args>
+    static auto dispatch(std::string_view path, Args &&...args) {
+        using result_t = std::common_type_t<std::invoke_result_t<
+            typename Routes::handler,
+            route_params<Routes::path, max_captures>, Args &&...>...>;
+        match_result m = match(path);
+        return [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            if constexpr (std::is_void_v<result_t>) {
+                return ((m.index == Is
+                             ? (invoke<Is>(m, std::forward<Args>(args)...),
+                                true)
+                             : false) ||
+                        ...);
+            } else {
+                std::optional<result_t> out;
+                static_cast<void>(
+                    ((m.index == Is
+                          ? (out.emplace(
+                                 invoke<Is>(m, std::forward<Args>(args)...)),
+                             true)
+                          : false) ||
+                     ...));
+                return out;
+            }
+        }(std::index_sequence_for<Routes...>{});
+    }
+};
+}  // namespace conststr
+
+#endif
@@ -0,0 +1,233 @@
+/* MIT License
+ *
+ * Copyright (c) 2024 Nichts Hsu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * @file scan.hpp
+ * @brief Parse strings with a format known at compile time.
+ */
+
+#ifndef CONSTSTR_SCAN_HPP
+#define CONSTSTR_SCAN_HPP
+
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "../conststr.hpp"
+
+namespace conststr {
+/**
+ * @brief Compile-time split of a `scan` format into literals and
+ * placeholders.
+ * @details
+ * The format consists of literal text and `{}` placeholders, `{{` and `}}`
+ * stand for literal braces. There is one more literal than placeholders, the
+ * first literal precedes the first placeholder and the last one follows the
+ * last placeholder; literals may be empty.
+ * @tparam Format format string
+ */
+template <cstr Format>
+struct scan_format {
+   private:
+    struct parsed {
+        std::array<char, Format.size() + 1> text{};
+        std::array<std::size_t, Format.size() + 2> bounds{};
+        std::size_t fields = 0;
+    };
+
+    static consteval parsed parse() {
+        parsed p;
+        std::size_t length = 0;
+        for (std::size_t i = 0; i < Format.size(); ++i) {
+            char ch = Format[i];
+            if ((ch == '{' || ch == '}') && i + 1 < Format.size() &&
+                Format[i + 1] == ch) {
+                p.text[length++] = ch;
+                ++i;
+            } else if (ch == '{') {
+                if (i + 1 >= Format.size() || Format[i + 1] != '}')
+                    throw "scan: '{' must be followed by '}'";
+                p.bounds[++p.fields] = length;
+                ++i;
+            } else if (ch == '}') {
+                throw "scan: unmatched '}'";
+            } else {
+                p.text[length++] = ch;
+            }
+        }
+        p.bounds[p.fields + 1] = length;
+        return p;
+    }
+
+    static constexpr parsed _parsed = parse();
+
+   public:
+    /**
+     * @brief Number of placeholders.
+     */
+    static constexpr std::size_t fields = _parsed.fields;
+
+    /**
+     * @brief Get the I-th literal, with escapes resolved.
+     * @tparam I index of literal, from 0 to `fields`
+     */
+    template <std::size_t I>
+    static constexpr std::string_view literal() noexcept {
+        return {_parsed.text.data() + _parsed.bounds[I],
+                _parsed.bounds[I + 1] - _parsed.bounds[I]};
+    }
+};
+
+/**
+ * @brief Internal implementation of `scan`.
+ * Parse the whole `field` into `out`.
+ */
+template <typename T>
+bool scan_field(std::string_view field, T &out) {
+    if constexpr (std::is_same_v<T, std::string_view>) {
+        out = field;
+        return true;
+    } else if constexpr (std::is_same_v<T, std::string>) {
+        out.assign(field);
+        return true;
+    } else if constexpr (std::is_same_v<T, char>) {
+        if (field.size() != 1) return false;
+        out = field[0];
+        return true;
+    } else if constexpr (std::is_same_v<T, bool>) {
+        if (field == "true" || field == "1")
+            out = true;
+        else if (field == "false" || field == "0")
+            out = false;
+        else
+            return false;
+        return true;
+    } else if constexpr (std::is_arithmetic_v<T>) {
+        const char *end = field.data() + field.size();
+        auto result = std::from_chars(field.data(), end, out);
+        return result.ec == std::errc() && result.ptr == end;
+    } else {
+        static_assert(!sizeof(T), "type is not supported by scan");
+    }
+}
+
+/**
+ * @brief Internal implementation of `scan`.
+ * Parse the longest numeric prefix of `input` into `out` and drop it.
+ */
+template <typename T>
+bool scan_prefix(std::string_view &input, T &out) {
+    if constexpr (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) {
+        const char *end = input.data() + input.size();
+        auto result = std::from_chars(input.data(), end, out);
+        if (result.ec != std::errc()) return false;
+        input.remove_prefix(std::size_t(result.ptr - input.data()));
+        return true;
+    } else {
+        static_assert(!sizeof(T),
+                      "a placeholder followed by another one must be numeric");
+    }
+}
+
+/**
+ * @brief Internal implementation of `scan`.
+ * Drop the literal `lit` from the front of `input`.
+ */
+constexpr bool scan_literal(std::string_view &input,
+                            std::string_view lit) noexcept {
+    if (!input.starts_with(lit)) return false;
+    input.remove_prefix(lit.size());
+    return true;
+}
+
+/**
+ * @brief Internal implementation of `scan`.
+ * Find the literal `lit` in `input`.
+ */
+inline std::size_t scan_find(std::string_view input,
+                             std::string_view lit) noexcept {
+    if (lit.size() == 1) {
+        const void *p = std::memchr(input.data(), lit[0], input.size());
+        return p ? std::size_t(static_cast<const char *>(p) - input.data())
+                 : std::string_view::npos;
+    }
+    return input.find(lit);
+}
+
+/**
+ * @brief Parse `input` with the format `Format` in one forward pass.
+ * @details
+ * For example:
+ * @code{.cpp}
+ * std::string_view level;
+ * int hour, minute;
+ * bool ok = conststr::scan<"[{}] {}:{}"_cs>(line, level, hour, minute);
+ * @endcode
+ * Literals must match exactly. A placeholder followed by a literal extends
+ * up to the first occurrence of that literal, a placeholder at the end takes
+ * the rest of the input, and a placeholder followed directly by another one
+ * takes the longest number at its position. Integers and floating-point
+ * numbers are parsed by `std::from_chars`; `std::string_view` outputs refer
+ * into `input`. See `scan_format` for the syntax of `Format`.
+ * @tparam Format format string with `{}` placeholders
+ * @param input string to be parsed
+ * @param outputs one output per placeholder: arithmetic types, `char`,
+ * `std::string` or `std::string_view`
+ * @return `true` if the whole `input` matches, otherwise `false`, in which
+ * case some outputs may have been assigned.
+ */
+template <cstr Format, typename... Outputs>
+bool scan(std::string_view input, Outputs &...outputs)
+    requires std::same_as<typename decltype(Format)::value_type, char>
+{
+    using format = scan_format<Format>;
+    static_assert(format::fields == sizeof...(Outputs),
+                  "number of outputs does not match the format");
+    if (!scan_literal(input, format::template literal<0>())) return false;
+    auto one = [&]<std::size_t I>(auto &out) {
+        constexpr std::string_view next = format::template literal<I + 1>();
+        if constexpr (I + 1 == format::fields && next.empty()) {
+            bool ok = scan_field(input, out);
+            input = {};
+            return ok;
+        } else if constexpr (next.empty()) {
+            return scan_prefix(input, out);
+        } else {
+            std::size_t pos = scan_find(input, next);
+            if (pos == std::string_view::npos) return false;
+            if (!scan_field(input.substr(0, pos), out)) return false;
+            input.remove_prefix(pos + next.size());
+            return true;
+        }
+    };
+    bool ok = [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+        return (one.template operator()<Is>(outputs) && ...);
+    }(std::index_sequence_for<Outputs...>{});
+    return ok && input.empty();
+}
+}  // namespace conststr
+
+#endif
@@ -0,0 +1,277 @@
+/* MIT License
+ *
+ * Copyright (c) 2024 Nichts Hsu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * @file static_map.hpp
+ * @brief Compile-time perfect hashing of string keys.
+ */
+
+#ifndef CONSTSTR_STATIC_MAP_HPP
+#define CONSTSTR_STATIC_MAP_HPP
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "../conststr.hpp"
+
+namespace conststr {
+/**
+ * @brief Key folding of `perfect_hash` comparing bytes as they are.
+ */
+struct case_sensitive {
+    static constexpr unsigned char fold(char ch) noexcept {
+        return static_cast<unsigned char>(ch);
+    }
+};
+
+/**
+ * @brief Key folding of `perfect_hash` ignoring ASCII case.
+ * @details
+ * Same as `charutils::tolower`, but branchless: `0x20` is OR-ed into the
+ * byte if and only if it is an uppercase ASCII letter.
+ */
+struct ascii_case_insensitive {
+    static constexpr unsigned char fold(char ch) noexcept {
+        auto byte = static_cast<unsigned char>(ch);
+        return byte | ((static_cast<unsigned char>(byte - 'A') < 26) << 5);
+    }
+};
+
+/**
+ * @brief Hash of a string for `perfect_hash`.
+ * @tparam Fold key folding applied to every byte
+ * @param str string to be hashed
+ * @param seed seed selecting one function of the family
+ * @return The hash value.
+ */
+template <typename Fold = case_sensitive>
+constexpr std::uint64_t seeded_hash(std::string_view str,
+                                    std::uint64_t seed) noexcept {
+    std::uint64_t hash =
+        0xCBF29CE484222325ull ^ (seed * 0x9E3779B97F4A7C15ull);
+    for (char ch : str) {
+        hash ^= Fold::fold(ch);
+        hash *= 0x100000001B3ull;
+    }
+    return hash ^ (hash >> 32);
+}
+
+/**
+ * @brief Compare two strings after folding.
+ */
+template <typename Fold = case_sensitive>
+constexpr bool folded_equal(std::string_view lhs,
+                            std::string_view rhs) noexcept {
+    if (lhs.size() != rhs.size()) return false;
+    for (std::size_t i = 0; i < lhs.size(); ++i)
+        if (Fold::fold(lhs[i]) != Fold::fold(rhs[i])) return false;
+    return true;
+}
+
+/**
+ * @brief Perfect hash from N strings to integers.
+ * @details
+ * Built at compile time by hash-and-displace: keys are distributed into
+ * buckets by a first hash, then each bucket, largest first, gets a seed
+ * for the second hash that places all of its keys into free slots. A lookup
+ * costs two hashes and one string comparison.
+ * @tparam N number of keys
+ * @tparam Fold key folding, `case_sensitive` or `ascii_case_insensitive`
+ */
+template <std::size_t N, typename Fold = case_sensitive>
+class perfect_hash {
+   public:
+    /**
+     * @brief Value returned by `find` for unknown keys.
+     */
+    static constexpr std::size_t npos = std::size_t(-1);
+
+    /**
+     * @brief Number of slots, a power of two.
+     */
+    static constexpr std::size_t slots = std::bit_ceil(N == 0 ? 1 : N);
+
+    /**
+     * @brief Build the table.
+     * @param entries pairs of key and value, keys must be distinct
+     */
+    consteval explicit perfect_hash(
+        const std::array<std::pair<std::string_view, std::size_t>, N>
+            &entries) {
+        for (std::size_t i = 0; i < N; ++i)
+            for (std::size_t j = i + 1; j < N; ++j)
+                if (folded_equal<Fold>(entries[i].first, entries[j].first))
+                    throw "perfect_hash: duplicate key";
+
+        _values.fill(npos);
+        std::array<std::size_t, slots> bucket_sizes{};
+        for (const auto &entry : entries)
+            ++bucket_sizes[bucket_of(entry.first)];
+
+        std::array<bool, slots> used{};
+        for (std::size_t done = 0; done < slots; ++done) {
+            std::size_t bucket = 0;
+            for (std::size_t b = 1; b < slots; ++b)
+                if (bucket_sizes[b] > bucket_sizes[bucket]) bucket = b;
+            if (bucket_sizes[bucket] == 0) break;
+            bucket_sizes[bucket] = 0;
+
+            for (std::uint64_t seed = 1;; ++seed) {
+                if (seed > 0x100000) throw "perfect_hash: no seed found";
+                std::array<bool, slots> taken = used;
+                bool ok = true;
+                for (const auto &entry : entries) {
+                    if (bucket_of(entry.first) != bucket) continue;
+                    std::size_t slot = slot_of(entry.first, seed);
+                    if (taken[slot]) {
+                        ok = false;
+                        break;
+                    }
+                    taken[slot] = true;
+                }
+                if (!ok) continue;
+                _seeds[bucket] = seed;
+                for (const auto &entry : entries) {
+                    if (bucket_of(entry.first) != bucket) continue;
+                    std::size_t slot = slot_of(entry.first, seed);
+                    _keys[slot] = entry.first;
+                    _values[slot] = entry.second;
+                }
+                used = taken;
+                break;
+            }
+        }
+    }
+
+    /**
+     * @brief Get the value of `key`.
+     * @return The value, or `npos` if `key` is unknown.
+     */
+    constexpr std::size_t find(std::string_view key) const noexcept {
+        std::size_t slot = slot_of(key, _seeds[bucket_of(key)]);
+        if (_values[slot] == npos || !folded_equal<Fold>(_keys[slot], key))
+            return npos;
+        return _values[slot];
+    }
+
+   private:
+    static constexpr std::size_t bucket_of(std::string_view key) noexcept {
+        return seeded_hash<Fold>(key, 0) & (slots - 1);
+    }
+
+    static constexpr std::size_t slot_of(std::string_view key,
+                                         std::uint64_t seed) noexcept {
+        return seeded_hash<Fold>(key, seed) & (slots - 1);
+    }
+
+    std::array<std::uint64_t, slots> _seeds{};
+    std::array<std::string_view, slots> _keys{};
+    std::array<std::size_t, slots> _values{};
+};
+
+/**
+ * @brief Set of string keys known at compile time, mapped to their indices.
+ * @details
+ * Lookups go through a `perfect_hash` built at compile time and cost two
+ * hashes and one comparison. For example:
+ * @code{.cpp}
+ * using methods = conststr::static_map<"GET"_cs, "POST"_cs, "PUT"_cs>;
+ * static_assert(methods::find("POST") == 1);
+ * @endcode
+ * @tparam Fold key folding, `case_sensitive` or `ascii_case_insensitive`
+ * @tparam Keys distinct keys
+ * @see static_map
+ * @see ci_static_map
+ */
+template <typename Fold, cstr... Keys>
+class basic_static_map {
+    // Keys of a case-insensitive map are stored lowercased.
+    template <cstr Key>
+    static constexpr auto stored = [] {
+        if constexpr (std::is_same_v<Fold, ascii_case_insensitive>)
+            return Key.lowercase();
+        else
+            return Key;
+    }();
+
+    static consteval auto build() {
+        std::array<std::pair<std::string_view, std::size_t>, sizeof...(Keys)>
+            entries{std::pair{std::string_view(stored<Keys>), 0}...};
+        for (std::size_t i = 0; i < entries.size(); ++i) entries[i].second = i;
+        return perfect_hash<sizeof...(Keys), Fold>(entries);
+    }
+
+    static constexpr auto _hash = build();
+
+   public:
+    /**
+     * @brief Value returned by `find` for unknown keys.
+     */
+    static constexpr std::size_t npos = std::size_t(-1);
+
+    /**
+     * @brief Number of keys.
+     */
+    static constexpr std::size_t size = sizeof...(Keys);
+
+    /**
+     * @brief Get the index of `key` in `Keys`.
+     * @return The index, or `npos` if `key` is not one of `Keys`.
+     */
+    static constexpr std::size_t find(std::string_view key) noexcept {
+        return _hash.find(key);
+    }
+
+    /**
+     * @brief Check whether `key` is one of `Keys`.
+     */
+    static constexpr bool contains(std::string_view key) noexcept {
+        return find(key) != npos;
+    }
+};
+
+/**
+ * @brief Case-sensitive `basic_static_map`.
+ */
+template <cstr... Keys>
+using static_map = basic_static_map<case_sensitive, Keys...>;
+
+/**
+ * @brief ASCII case-insensitive `basic_static_map`, for protocol header names.
+ * @details
+ * Keys are lowercased with `cstr::lowercase()` at compile time, the input is
+ * folded byte by byte while hashing and comparing, without a temporary copy:
+ * @code{.cpp}
+ * using headers = conststr::ci_static_map<"Content-Type"_cs, "Host"_cs>;
+ * static_assert(headers::find("HOST") == 1);
+ * @endcode
+ */
+template <cstr... Keys>
+using ci_static_map = basic_static_map<ascii_case_insensitive, Keys...>;
+}  // namespace conststr
+
+#endif
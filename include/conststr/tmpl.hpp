@@ -0,0 +1,467 @@
+/* MIT License
+ *
+ * Copyright (c) 2024 Nichts Hsu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * @file tmpl.hpp
+ * @brief Mustache-style text templates compiled at compile time.
+ */
+
+#ifndef CONSTSTR_TMPL_HPP
+#define CONSTSTR_TMPL_HPP
+
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "../reflect.hpp"
+
+namespace conststr {
+/**
+ * @brief Kind of a token of a compiled template.
+ */
+enum class tmpl_token_kind : std::uint8_t {
+    text,      // literal bytes
+    slot,      // {{name}}
+    section,   // {{#name}} ... {{/name}}
+    inverted,  // {{^name}} ... {{/name}}
+    close,     // {{/name}}
+};
+
+/**
+ * @brief Token of a compiled template.
+ * @details
+ * `offset` and `size` locate the literal bytes or the name in the template
+ * source. For sections `end` is the index of the matching `close` token.
+ */
+struct tmpl_token {
+    tmpl_token_kind kind = tmpl_token_kind::text;
+    std::size_t offset = 0;
+    std::size_t size = 0;
+    std::size_t end = 0;
+};
+
+/**
+ * @brief Internal implementation of `tmpl`.
+ * Split the template into tokens, counting only if `tokens` is `nullptr`.
+ */
+struct tmpl_parser {
+    std::string_view src;
+    tmpl_token *tokens = nullptr;
+    std::size_t count = 0;
+
+    constexpr void push(tmpl_token token) {
+        if (tokens) tokens[count] = token;
+        ++count;
+    }
+
+    constexpr std::string_view name_of(std::size_t index) const {
+        return src.substr(tokens[index].offset, tokens[index].size);
+    }
+
+    constexpr void parse() {
+        constexpr std::size_t max_depth = 32;
+        std::size_t open[max_depth]{};
+        std::size_t depth = 0;
+        std::size_t pos = 0;
+        while (pos < src.size()) {
+            std::size_t tag = src.find("{{", pos);
+            if (tag == std::string_view::npos) tag = src.size();
+            if (tag != pos) push({tmpl_token_kind::text, pos, tag - pos});
+            if (tag == src.size()) break;
+
+            bool triple = src.substr(tag, 3) == "{{{";
+            std::size_t begin = tag + (triple ? 3 : 2);
+            std::size_t close = src.find(triple ? "}}}" : "}}", begin);
+            if (close == std::string_view::npos) throw "tmpl: unclosed tag";
+            pos = close + (triple ? 3 : 2);
+
+            tmpl_token_kind kind = tmpl_token_kind::slot;
+            if (!triple && begin < close) {
+                switch (src[begin]) {
+                    case '!': continue;
+                    case '#': kind = tmpl_token_kind::section; break;
+                    case '^': kind = tmpl_token_kind::inverted; break;
+                    case '/': kind = tmpl_token_kind::close; break;
+                    case '&': break;
+                    default: --begin;
+                }
+                ++begin;
+            }
+            while (begin < close && charutils::isspace(src[begin])) ++begin;
+            while (close > begin && charutils::isspace(src[close - 1])) --close;
+            if (begin == close) throw "tmpl: empty tag";
+            push({kind, begin, close - begin});
+
+            if (!tokens) continue;
+            std::size_t index = count - 1;
+            if (kind == tmpl_token_kind::section ||
+                kind == tmpl_token_kind::inverted) {
+                if (depth == max_depth) throw "tmpl: sections nested too deep";
+                open[depth++] = index;
+            } else if (kind == tmpl_token_kind::close) {
+                if (depth == 0) throw "tmpl: unexpected section close";
+                std::size_t section = open[--depth];
+                if (name_of(section) != name_of(index))
+                    throw "tmpl: mismatched section close";
+                tokens[section].end = index;
+            }
+        }
+        if (tokens && depth != 0) throw "tmpl: unclosed section";
+    }
+};
+
+/**
+ * @brief Internal implementation of `tmpl`.
+ * Maximum number of characters written by `std::to_chars` for `V`.
+ */
+template <typename V>
+constexpr std::size_t tmpl_number_chars =
+    std::is_floating_point_v<V> ? std::numeric_limits<V>::max_digits10 + 8
+                                : std::numeric_limits<V>::digits10 + 2;
+
+/**
+ * @brief Internal implementation of `tmpl`.
+ * Sink that writes the rendered text.
+ */
+struct tmpl_writer {
+    char *pos;
+
+    void put(const char *data, std::size_t size) noexcept {
+        std::memcpy(pos, data, size);
+        pos += size;
+    }
+
+    template <typename V>
+    void put_number(V value) noexcept {
+        pos = std::to_chars(pos, pos + tmpl_number_chars<V>, value).ptr;
+    }
+};
+
+/**
+ * @brief Internal implementation of `tmpl`.
+ * Sink that computes an upper bound of the size of the rendered text.
+ */
+struct tmpl_measurer {
+    std::size_t size = 0;
+
+    constexpr void put(const char *, std::size_t n) noexcept { size += n; }
+
+    template <typename V>
+    constexpr void put_number(V) noexcept {
+        size += tmpl_number_chars<V>;
+    }
+};
+
+/**
+ * @brief Compiled mustache-style template.
+ * @details
+ * Supported tags:
+ * - `{{name}}`, `{{{name}}}` and `{{&name}}`: value of `name`, unescaped;
+ * - `{{#name}}...{{/name}}`: rendered once if `name` is a true boolean or
+ *   non-zero number, once with `name` as context if it is a struct, a
+ *   non-empty string or an engaged optional, and once per element if it is
+ *   a range;
+ * - `{{^name}}...{{/name}}`: rendered if `name` is false, zero, empty or
+ *   disengaged;
+ * - `{{.}}`: the current context itself, e.g. an element of a range;
+ * - `{{! comment}}`: ignored.
+ *
+ * Names are bound to reflected members through `reflect::index_of` at
+ * compile time, searching from the innermost context outwards; an unknown
+ * name is a compile error. Values may be strings, characters, booleans or
+ * numbers.
+ *
+ * Rendering is one pass over the precompiled tokens: literal segments are
+ * copied with a constant size and values are written straight into a
+ * buffer presized to `max_size()`.
+ * @tparam Src template text
+ * @code
+ * struct inbox { std::string_view name; int count; };
+ * using greeting = conststr::tmpl<"Hello {{name}}, {{count}} msgs"_cs>;
+ * greeting::render(inbox{"Ann", 3});  // "Hello Ann, 3 msgs"
+ * @endcode
+ */
+template <cstr Src>
+    requires std::same_as<typename decltype(Src)::value_type, char>
+struct tmpl {
+   private:
+    static constexpr std::size_t token_count = [] {
+        tmpl_parser p{std::string_view(Src)};
+        p.parse();
+        return p.count;
+    }();
+
+   public:
+    /**
+     * @brief Tokens of the template.
+     */
+    static constexpr std::array<tmpl_token, token_count> tokens = [] {
+        std::array<tmpl_token, token_count> ret{};
+        tmpl_parser p{std::string_view(Src), ret.data()};
+        p.parse();
+        return ret;
+    }();
+
+    /**
+     * @brief Total size of the literal segments.
+     */
+    static constexpr std::size_t literal_size = [] {
+        std::size_t size = 0;
+        for (const auto &token : tokens)
+            if (token.kind == tmpl_token_kind::text) size += token.size;
+        return size;
+    }();
+
+    /**
+     * @brief Get an upper bound of the size of `render(ctx)`.
+     * @details
+     * Strings count with their exact size and numbers with their maximum.
+     */
+    template <typename T>
+    static constexpr std::size_t max_size(const T &ctx) {
+        tmpl_measurer sink;
+        render_tokens<0, token_count>(sink, ctx);
+        return sink.size;
+    }
+
+    /**
+     * @brief Render into `out`, which must hold at least `max_size(ctx)`
+     * bytes.
+     * @return Pointer past the last written byte.
+     */
+    template <typename T>
+    static char *render_to(const T &ctx, char *out) {
+        tmpl_writer sink{out};
+        render_tokens<0, token_count>(sink, ctx);
+        return sink.pos;
+    }
+
+    /**
+     * @brief Render to a new string.
+     */
+    template <typename T>
+    static std::string render(const T &ctx) {
+        std::string ret(max_size(ctx), '\0');
+        ret.resize(render_to(ctx, ret.data()) - ret.data());
+        return ret;
+    }
+
+   private:
+    template <std::size_t I>
+    static constexpr auto name = Src.template substr<tokens[I].offset,
+                                                     tokens[I].size>();
+
+    template <cstr Name, typename C>
+    static consteval bool has_member() {
+        if constexpr (!reflect::reflectable<C>) {
+            return false;
+        } else {
+            return []<std::size_t... I>(std::index_sequence<I...>) {
+                return ((std::string_view(reflect::name_of<C, I>) ==
+                         std::string_view(Name)) ||
+                        ...);
+            }(std::make_index_sequence<reflect::number_of_members<C>>{});
+        }
+    }
+
+    template <cstr Name, typename C, typename... Rest>
+    static constexpr const auto &lookup(const C &ctx, const Rest &...rest) {
+        if constexpr (std::string_view(Name) == ".") {
+            return ctx;
+        } else if constexpr (has_member<Name, C>()) {
+            return reflect::member_of<reflect::index_of<C, Name>>(ctx);
+        } else {
+            static_assert(sizeof...(Rest) > 0, "tmpl: unknown name");
+            return lookup<Name>(rest...);
+        }
+    }
+
+    template <typename Sink, typename V>
+    static constexpr void put_value(Sink &sink, const V &value) {
+        if constexpr (std::is_convertible_v<const V &, std::string_view>) {
+            std::string_view sv = value;
+            sink.put(sv.data(), sv.size());
+        } else if constexpr (std::same_as<V, char>) {
+            sink.put(&value, 1);
+        } else if constexpr (std::same_as<V, bool>) {
+            if (value)
+                sink.put("true", 4);
+            else
+                sink.put("false", 5);
+        } else if constexpr (std::is_arithmetic_v<V>) {
+            sink.put_number(value);
+        } else {
+            static_assert(std::is_arithmetic_v<V>,
+                          "tmpl: value cannot be rendered");
+        }
+    }
+
+    template <std::size_t Begin, std::size_t End, typename Sink,
+              typename... Ctx>
+    static constexpr void section(Sink &sink, const auto &value,
+                                  const Ctx &...ctx) {
+        using V = std::remove_cvref_t<decltype(value)>;
+        if constexpr (std::is_arithmetic_v<V>) {
+            if (value) render_tokens<Begin, End>(sink, ctx...);
+        } else if constexpr (std::is_convertible_v<const V &,
+                                                   std::string_view>) {
+            if (!std::string_view(value).empty())
+                render_tokens<Begin, End>(sink, value, ctx...);
+        } else if constexpr (std::ranges::range<const V>) {
+            for (const auto &element : value)
+                render_tokens<Begin, End>(sink, element, ctx...);
+        } else if constexpr (requires { value.has_value(); *value; }) {
+            if (value.has_value())
+                render_tokens<Begin, End>(sink, *value, ctx...);
+        } else {
+            render_tokens<Begin, End>(sink, value, ctx...);
+        }
+    }
+
+    template <typename V>
+    static constexpr bool falsy(const V &value) {
+        if constexpr (std::is_arithmetic_v<V>)
+            return !value;
+        else if constexpr (std::is_convertible_v<const V &, std::string_view>)
+            return std::string_view(value).empty();
+        else if constexpr (std::ranges::range<const V>)
+            return std::ranges::empty(value);
+        else if constexpr (requires { value.has_value(); })
+            return !value.has_value();
+        else
+            return false;
+    }
+
+    /**
+     * @brief Index of the first slot with the same name as the I-th token if
+     * it is a slot, otherwise I.
+     */
+    static constexpr auto canonical = [] {
+        auto name_view = [](std::size_t i) {
+            return std::string_view(Src).substr(tokens[i].offset,
+                                                tokens[i].size);
+        };
+        std::array<std::size_t, token_count> ret{}, distinct{};
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < token_count; ++i) {
+            ret[i] = i;
+            if (tokens[i].kind != tmpl_token_kind::slot) continue;
+            for (std::size_t j = 0; j < count && ret[i] == i; ++j)
+                if (name_view(distinct[j]) == name_view(i))
+                    ret[i] = distinct[j];
+            if (ret[i] == i) distinct[count++] = i;
+        }
+        return ret;
+    }();
+
+    /**
+     * @brief Piece of a token range: literal bytes followed by one token.
+     */
+    struct unit {
+        std::size_t offset = 0;
+        std::size_t size = 0;
+        std::size_t token = token_count;  // none if `token_count`
+    };
+
+    /**
+     * @brief Units of the tokens in `[Begin, End)` outside of sections.
+     * @details
+     * Rendering a range expands over its units instead of recursing per
+     * token, and slots of the same name share one instantiation through
+     * `canonical`, so a long template neither nests templates deeper than its
+     * sections nor instantiates a function per token.
+     */
+    template <std::size_t Begin, std::size_t End>
+    static constexpr auto units = [] {
+        auto split = [](unit *out) {
+            std::size_t count = 0;
+            unit current;
+            bool has_text = false;
+            for (std::size_t i = Begin; i < End; ++i) {
+                const tmpl_token &token = tokens[i];
+                if (token.kind == tmpl_token_kind::text) {
+                    if (has_text) {
+                        if (out) out[count] = current;
+                        ++count;
+                        current = {};
+                    }
+                    current.offset = token.offset;
+                    current.size = token.size;
+                    has_text = true;
+                    continue;
+                }
+                current.token = canonical[i];
+                if (out) out[count] = current;
+                ++count;
+                current = {};
+                has_text = false;
+                if (token.kind != tmpl_token_kind::slot) i = token.end;
+            }
+            if (has_text) {
+                if (out) out[count] = current;
+                ++count;
+            }
+            return count;
+        };
+        std::array<unit, split(nullptr)> ret{};
+        split(ret.data());
+        return ret;
+    }();
+
+    template <std::size_t I, typename Sink, typename... Ctx>
+    static constexpr void render_token(Sink &sink, const Ctx &...ctx) {
+        constexpr auto kind =
+            I < token_count ? tokens[I].kind : tmpl_token_kind::text;
+        if constexpr (kind == tmpl_token_kind::slot) {
+            put_value(sink, lookup<name<I>>(ctx...));
+        } else if constexpr (kind == tmpl_token_kind::section) {
+            section<I + 1, tokens[I].end>(sink, lookup<name<I>>(ctx...),
+                                          ctx...);
+        } else if constexpr (kind == tmpl_token_kind::inverted) {
+            if (falsy(lookup<name<I>>(ctx...)))
+                render_tokens<I + 1, tokens[I].end>(sink, ctx...);
+        }
+    }
+
+    template <std::size_t Begin, std::size_t End, typename Sink,
+              typename... Ctx>
+    static constexpr void render_tokens(Sink &sink, const Ctx &...ctx) {
+        using range = std::remove_cvref_t<decltype(units<Begin, End>)>;
+        [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            ((sink.put(Src.data() + units<Begin, End>[Is].offset,
+                       units<Begin, End>[Is].size),
+              render_token<units<Begin, End>[Is].token>(sink, ctx...)),
+             ...);
+        }(std::make_index_sequence<std::tuple_size_v<range>>{});
+    }
+};
+}  // namespace conststr
+
+#endif  // CONSTSTR_TMPL_HPP
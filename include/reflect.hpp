@@ -29,6 +29,8 @@
 #ifndef REFLECT_HPP
 #define REFLECT_HPP
 
+#include <bit>
+#include <cstdint>
 #include <functional>
 
 #include "conststr.hpp"
@@ -1867,6 +1869,53 @@ template <typename T, std::size_t N>
 constexpr auto name_of = name_of_ptr<cptr_of_member<T, N>()>;
 #endif
 
+/**
+ * @brief Core function to get type name via compiler built-in macro.
+ * @tparam T the type you want to reflect
+ * @return A compile-time string containing the signature of this function.
+ * @see type_name
+ */
+template <typename T>
+consteval auto pretty_type_name() {
+#if defined(__clang__) || defined(__GNUC__)
+    return conststr::cstr(__PRETTY_FUNCTION__);
+#elif defined(_MSC_VER)
+    return conststr::cstr(__FUNCSIG__);
+#endif
+}
+
+/**
+ * @brief Internal implementation of `type_name`.
+ * Extract the type name from the output of `pretty_type_name()`.
+ * @tparam T the type you want to reflect
+ * @return Name of the type.
+ * @see type_name
+ */
+template <typename T>
+consteval auto type_name_impl() {
+    constexpr auto name = pretty_type_name<T>();
+#if defined(__clang__) || defined(__GNUC__)
+    constexpr auto prefix = conststr::cstr("T = ");
+    constexpr auto suffix = conststr::cstr("]");
+#elif defined(_MSC_VER)
+    constexpr auto prefix = conststr::cstr("pretty_type_name<");
+    constexpr auto suffix = conststr::cstr(">(void)");
+#endif
+    constexpr auto begin = name.find(prefix) + prefix.size();
+    constexpr auto end = name.rfind(suffix);
+    return name.template substr<begin, end - begin>();
+}
+
+/**
+ * @brief Name of type `T`.
+ * @details
+ * For example, `type_name<int>` is `"int"_cs`.
+ * @note The spelling of non-fundamental types depends on the compiler.
+ * @tparam T any type
+ */
+template <typename T>
+constexpr auto type_name = type_name_impl<T>();
+
 /**
  * @brief Internal implementation of `index_of`.
  * Get the index of the member by its name.
@@ -1907,6 +1956,39 @@ constexpr size_t index_of = index_of_impl<T, Name, 0>();
 template <typename T, conststr::cstr Name>
 using type_of_member = type_of<T, index_of<T, Name>>;
 
+/**
+ * @brief Internal implementation of `offset_of`.
+ * @tparam T any default-constructible aggregate type
+ * @tparam N index of member
+ * @return Offset of the member in bytes.
+ * @see offset_of
+ */
+template <typename T, std::size_t N>
+consteval std::size_t offset_of_impl() {
+    constexpr std::size_t align = alignof(type_of<T, N>);
+    if constexpr (N == 0)
+        return 0;
+    else {
+        constexpr std::size_t end =
+            offset_of_impl<T, N - 1>() + sizeof(type_of<T, N - 1>);
+        return (end + align - 1) / align * align;
+    }
+}
+
+/**
+ * @brief Offset in bytes of N-th member of a default-constructible aggregate type `T`.
+ * @details
+ * Computed from the size and alignment of the members, in the same way as the
+ * compiler lays out a standard-layout type. Equivalent to `offsetof` but also
+ * available in constant context.
+ * @warning Not applicable to members declared with `alignas` or
+ * `[[no_unique_address]]`.
+ * @tparam T any default-constructible aggregate type
+ * @tparam N index of member
+ */
+template <typename T, std::size_t N>
+constexpr std::size_t offset_of = offset_of_impl<T, N>();
+
 /**
  * @brief Get member reference of object `t`.
  * @details
@@ -1968,6 +2050,143 @@ constexpr decltype(auto) member_of(T &&t)
     return member_of<index_of<std::remove_cvref_t<T>, Name>, T>(
         std::forward<T>(t));
 }
+
+/**
+ * @brief This concept is satisfied if members of `T` can be reflected.
+ * @details
+ * That is a default-constructible aggregate class type which is not tuple-like,
+ * for example, `std::array` is excluded.
+ * @tparam T any type
+ */
+template <typename T>
+concept reflectable =
+    std::is_class_v<T> && std::is_aggregate_v<T> &&
+    std::is_default_constructible_v<T> &&
+    !requires { std::tuple_size<T>::value; };
+
+/**
+ * @brief Feed `value` into the 64-bit FNV-1a hash `hash` byte by byte.
+ * @param hash current hash value
+ * @param value integer to be hashed, in little-endian order
+ * @return The new hash value.
+ */
+constexpr std::uint64_t fnv1a(std::uint64_t hash, std::uint64_t value) {
+    for (std::size_t i = 0; i < sizeof(value); ++i) {
+        hash ^= (value >> (i * 8)) & 0xFF;
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
+
+/**
+ * @brief Feed all characters of `str` into the 64-bit FNV-1a hash `hash`.
+ * @param hash current hash value
+ * @param str string to be hashed
+ * @return The new hash value.
+ */
+template <std::size_t N, typename U>
+constexpr std::uint64_t fnv1a(std::uint64_t hash,
+                              const conststr::cstr<N, char, U> &str) {
+    for (char ch : str) {
+        hash ^= static_cast<unsigned char>(ch);
+        hash *= 0x100000001B3ull;
+    }
+    return fnv1a(hash, N);
+}
+
+template <typename T>
+constexpr std::uint64_t schema_hash_impl();
+
+/**
+ * @brief Internal implementation of `schema_hash`.
+ * Hash the type of a member.
+ * @details
+ * Arithmetic types are hashed by their kind and size rather than their name,
+ * so `long` and `long long` of the same width are compatible. Plain `char`
+ * and `wchar_t` are kinds of their own, since their signedness depends on
+ * the platform. Enumerations
+ * are hashed as their underlying type, arrays by their element type and
+ * extent, aggregates recursively. Other types have no portable spelling, so
+ * they are rejected.
+ * @tparam M type of member
+ * @param hash current hash value
+ * @return The new hash value.
+ */
+template <typename M>
+constexpr std::uint64_t schema_hash_of_type(std::uint64_t hash) {
+    if constexpr (std::is_array_v<M>)
+        return fnv1a(schema_hash_of_type<std::remove_extent_t<M>>(hash),
+                     std::extent_v<M>);
+    else if constexpr (std::is_same_v<M, bool>)
+        return fnv1a(hash, conststr::cstr("bool"));
+    else if constexpr (std::is_same_v<M, char>)
+        return fnv1a(hash, conststr::cstr("char"));
+    else if constexpr (std::is_same_v<M, wchar_t>)
+        return fnv1a(fnv1a(hash, conststr::cstr("wchar")), sizeof(M));
+    else if constexpr (std::is_floating_point_v<M>)
+        return fnv1a(fnv1a(hash, conststr::cstr("float")), sizeof(M));
+    else if constexpr (std::is_integral_v<M> && std::is_signed_v<M>)
+        return fnv1a(fnv1a(hash, conststr::cstr("int")), sizeof(M));
+    else if constexpr (std::is_integral_v<M>)
+        return fnv1a(fnv1a(hash, conststr::cstr("uint")), sizeof(M));
+    else if constexpr (std::is_enum_v<M>)
+        return schema_hash_of_type<std::underlying_type_t<M>>(
+            fnv1a(hash, conststr::cstr("enum")));
+    else if constexpr (reflectable<M>)
+        return fnv1a(hash, schema_hash_impl<M>());
+    else
+        static_assert(reflectable<M>,
+                      "schema_hash: member type has no portable fingerprint");
+}
+
+/**
+ * @brief Internal implementation of `schema_hash`.
+ * @tparam T any default-constructible aggregate type
+ * @return Hash value of the schema of `T`.
+ * @see schema_hash
+ */
+template <typename T>
+constexpr std::uint64_t schema_hash_impl() {
+    std::uint64_t hash = fnv1a(0xCBF29CE484222325ull, sizeof(T));
+    hash = fnv1a(hash, alignof(T));
+    hash = fnv1a(hash, number_of_members<T>);
+    [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+        ((hash = schema_hash_of_type<type_of<T, Is>>(
+              fnv1a(fnv1a(hash, name_of<T, Is>), offset_of<T, Is>))),
+         ...);
+    }(std::make_index_sequence<number_of_members<T>>{});
+    return hash;
+}
+
+/**
+ * @brief 64-bit fingerprint of the schema of a default-constructible aggregate type `T`.
+ * @details
+ * The hash covers the byte order of the target, the size and alignment of
+ * `T` and the name, offset and type of every member, and recurses into nested
+ * aggregates. It does not depend on the compiler, so two types with the same
+ * fingerprint have the same binary layout and it can be put in a message
+ * header; the reader only needs to compare one integer before reinterpreting
+ * the payload:
+ * @code{.cpp}
+ * if (header.schema == reflect::schema_hash<Message>)
+ *     std::memcpy(&msg, payload, sizeof(Message));
+ * else
+ *     decode_field_by_field(msg, payload);
+ * @endcode
+ * @warning Offsets come from `offset_of`, which does not see `alignas` or
+ * `[[no_unique_address]]` on members. Such members usually change `sizeof` or
+ * `alignof` of `T`, which are hashed, but do not reinterpret types using them
+ * across builds without checking the layout otherwise.
+ * @tparam T any default-constructible aggregate type whose members are
+ * arithmetic types, enumerations, arrays or such aggregates
+ */
+template <typename T>
+constexpr std::uint64_t schema_hash = [] {
+    if constexpr (std::endian::native == std::endian::big)
+        return fnv1a(schema_hash_impl<T>(), conststr::cstr("big"));
+    else
+        return fnv1a(schema_hash_impl<T>(), conststr::cstr("little"));
+}();
 }  // namespace reflect
 
 #endif
\ No newline at end of file
@@ -0,0 +1,351 @@
+/* MIT License
+ *
+ * Copyright (c) 2024 Nichts Hsu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * @file aggregate.hpp
+ * @brief Columnar aggregations over ranges of reflected records.
+ */
+
+#ifndef REFLECT_AGGREGATE_HPP
+#define REFLECT_AGGREGATE_HPP
+
+#include <array>
+#include <cstring>
+#include <optional>
+#include <ranges>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "buffer_view.hpp"
+
+namespace reflect {
+/**
+ * @brief Get a view of the N-th member over a contiguous range of records.
+ * @details
+ * For example, `reflect::column<1>(vec)` for `std::vector<T>`.
+ * @tparam N index of member
+ * @tparam R DO NOT specify it, let it be automatically deduced
+ * @param range contiguous range of default-constructible aggregate type
+ * @return View of the member with a stride of `sizeof(T)`.
+ */
+template <std::size_t N, std::ranges::contiguous_range R>
+auto column(R &&range) noexcept {
+    using T = std::ranges::range_value_t<R>;
+    using ref = std::ranges::range_reference_t<R>;
+    using M = std::conditional_t<std::is_const_v<std::remove_reference_t<ref>>,
+                                 const type_of<T, N>, type_of<T, N>>;
+    using byte_type =
+        std::conditional_t<std::is_const_v<M>, const std::byte, std::byte>;
+    auto *first = reinterpret_cast<byte_type *>(std::ranges::data(range));
+    return strided_view<M>(first + offset_of<T, N>, sizeof(T),
+                           std::ranges::size(range));
+}
+
+/**
+ * @brief Get a view of the member over a contiguous range of records via its name.
+ * @details
+ * For example, `reflect::column<"price">(vec)` for `std::vector<T>`.
+ * @tparam Name name of member
+ * @tparam R DO NOT specify it, let it be automatically deduced
+ * @param range contiguous range of default-constructible aggregate type
+ * @return View of the member with a stride of `sizeof(T)`.
+ */
+template <conststr::cstr Name, std::ranges::contiguous_range R>
+auto column(R &&range) noexcept
+    requires std::same_as<typename decltype(Name)::value_type, char>
+{
+    return column<index_of<std::ranges::range_value_t<R>, Name>>(
+        std::forward<R>(range));
+}
+
+/**
+ * @brief Parallel execution policy of aggregations.
+ * @details
+ * The input is split into `threads` chunks, but never into chunks smaller
+ * than `grain` elements.
+ */
+struct parallel {
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    std::size_t grain = std::size_t(1) << 16;
+};
+
+/**
+ * @brief Accumulator type for summing elements of type `M`.
+ * @details
+ * 64-bit integers for integral types, at least `double` for floating types.
+ * @tparam M arithmetic type
+ */
+template <typename M>
+using sum_t = std::conditional_t<
+    std::is_floating_point_v<M>, std::common_type_t<M, double>,
+    std::conditional_t<std::is_signed_v<M>, std::int64_t, std::uint64_t>>;
+
+/**
+ * @brief Internal implementation of aggregations.
+ * Fold the elements of `view` into `init` with `op`.
+ * @details
+ * Elements are folded into `lanes` independent accumulators, so there is no
+ * loop-carried dependency between neighboring elements. When the elements
+ * are contiguous, the compiler turns the inner loop into packed SIMD.
+ * @tparam M type of element
+ * @param view elements to fold
+ * @param init initial value of every accumulator
+ * @param op binary operation of an accumulator and an element
+ * @param combine binary operation of two accumulators
+ * @return The folded value.
+ */
+template <typename M, typename Acc, typename Op, typename Combine>
+Acc fold_lanes(strided_view<M> view, Acc init, Op op, Combine combine) {
+    constexpr std::size_t lanes = 32 / sizeof(Acc) > 1 ? 32 / sizeof(Acc) : 2;
+    std::array<Acc, lanes> acc;
+    acc.fill(init);
+    const std::size_t count = view.size();
+    std::size_t i = 0;
+    if (view.stride() == sizeof(M)) {
+        // A constant stride lets the loads through memcpy become packed.
+        const std::byte *first = view.data();
+        for (; i + lanes <= count; i += lanes)
+            for (std::size_t l = 0; l < lanes; ++l) {
+                std::remove_cv_t<M> value;
+                std::memcpy(&value, first + (i + l) * sizeof(M),
+                            sizeof(value));
+                acc[l] = op(acc[l], value);
+            }
+    } else {
+        for (; i + lanes <= count; i += lanes)
+            for (std::size_t l = 0; l < lanes; ++l)
+                acc[l] = op(acc[l], view[i + l]);
+    }
+    for (std::size_t l = 0; i < count; ++i, ++l)
+        acc[l] = op(acc[l], view[i]);
+    for (std::size_t l = 1; l < lanes; ++l) acc[0] = combine(acc[0], acc[l]);
+    return acc[0];
+}
+
+/**
+ * @brief Internal implementation of aggregations.
+ * Same as `fold_lanes`, but folds chunks of `view` on multiple threads.
+ * @param policy how to split the input
+ */
+template <typename M, typename Acc, typename Op, typename Combine>
+Acc fold_lanes(strided_view<M> view, Acc init, Op op, Combine combine,
+               parallel policy) {
+    const std::size_t count = view.size();
+    std::size_t chunks = std::min<std::size_t>(
+        std::max(1u, policy.threads),
+        (count + policy.grain - 1) / std::max<std::size_t>(policy.grain, 1));
+    if (chunks <= 1) return fold_lanes(view, init, op, combine);
+
+    std::vector<Acc> results(chunks, init);
+    // std::jthread joins on destruction, so workers already started are
+    // joined if starting another one throws.
+    std::vector<std::jthread> workers;
+    workers.reserve(chunks - 1);
+    const std::size_t size = count / chunks;
+    for (std::size_t c = 0; c < chunks; ++c) {
+        std::size_t first = c * size;
+        std::size_t last = c + 1 == chunks ? count : first + size;
+        strided_view<M> chunk(view.data() + first * view.stride(),
+                              view.stride(), last - first);
+        auto task = [=, &results] {
+            results[c] = fold_lanes(chunk, init, op, combine);
+        };
+        if (c + 1 == chunks)
+            task();
+        else
+            workers.emplace_back(task);
+    }
+    for (auto &worker : workers) worker.join();
+    Acc result = results[0];
+    for (std::size_t c = 1; c < chunks; ++c)
+        result = combine(result, results[c]);
+    return result;
+}
+
+/**
+ * @brief Sum of all elements.
+ * @param view elements, for example, returned by `column<Name>(range)`
+ * @param policy optional parallel policy
+ * @return The sum, with type `sum_t<M>`.
+ */
+template <typename M, typename... Policy>
+sum_t<std::remove_cv_t<M>> sum(strided_view<M> view, Policy... policy)
+    requires(sizeof...(Policy) <= 1)
+{
+    using S = sum_t<std::remove_cv_t<M>>;
+    return fold_lanes(
+        view, S{}, [](S acc, const M &v) { return acc + S(v); },
+        std::plus<S>{}, policy...);
+}
+
+/**
+ * @brief Minimum of all elements.
+ * @param view elements, for example, returned by `column<Name>(range)`
+ * @param policy optional parallel policy
+ * @return The minimum, or `std::nullopt` if `view` is empty.
+ */
+template <typename M, typename... Policy>
+std::optional<std::remove_cv_t<M>> min(strided_view<M> view,
+                                       Policy... policy)
+    requires(sizeof...(Policy) <= 1)
+{
+    using V = std::remove_cv_t<M>;
+    if (view.empty()) return std::nullopt;
+    auto less = [](V acc, const M &v) { return v < acc ? V(v) : acc; };
+    return fold_lanes(view, V(view[0]), less, less, policy...);
+}
+
+/**
+ * @brief Maximum of all elements.
+ * @param view elements, for example, returned by `column<Name>(range)`
+ * @param policy optional parallel policy
+ * @return The maximum, or `std::nullopt` if `view` is empty.
+ */
+template <typename M, typename... Policy>
+std::optional<std::remove_cv_t<M>> max(strided_view<M> view,
+                                       Policy... policy)
+    requires(sizeof...(Policy) <= 1)
+{
+    using V = std::remove_cv_t<M>;
+    if (view.empty()) return std::nullopt;
+    auto greater = [](V acc, const M &v) { return acc < v ? V(v) : acc; };
+    return fold_lanes(view, V(view[0]), greater, greater, policy...);
+}
+
+/**
+ * @brief Arithmetic mean of all elements.
+ * @param view elements, for example, returned by `column<Name>(range)`
+ * @param policy optional parallel policy
+ * @return The mean, or `std::nullopt` if `view` is empty.
+ */
+template <typename M, typename... Policy>
+std::optional<double> mean(strided_view<M> view, Policy... policy)
+    requires(sizeof...(Policy) <= 1)
+{
+    if (view.empty()) return std::nullopt;
+    return double(sum(view, policy...)) / double(view.size());
+}
+
+/**
+ * @brief Count the elements for which predicate `pred` returns `true`.
+ * @param view elements, for example, returned by `column<Name>(range)`
+ * @param pred unary predicate
+ * @param policy optional parallel policy
+ * @return Number of the matched elements.
+ */
+template <typename M, typename UnaryPredicate, typename... Policy>
+std::size_t count_if(strided_view<M> view, UnaryPredicate pred,
+                     Policy... policy)
+    requires(sizeof...(Policy) <= 1)
+{
+    return fold_lanes(
+        view, std::size_t(0),
+        [pred](std::size_t acc, const M &v) {
+            return acc + std::size_t(bool(pred(v)));
+        },
+        std::plus<std::size_t>{}, policy...);
+}
+
+/**
+ * @brief Sum of the member over a contiguous range of records.
+ * @details
+ * For example, `reflect::sum<"price">(vec)`.
+ * @tparam Name name of member
+ * @param range contiguous range of default-constructible aggregate type
+ * @param policy optional parallel policy
+ * @return The sum, with type `sum_t<M>`.
+ */
+template <conststr::cstr Name, std::ranges::contiguous_range R,
+          typename... Policy>
+auto sum(R &&range, Policy... policy)
+    requires std::same_as<typename decltype(Name)::value_type, char>
+{
+    return sum(column<Name>(range), policy...);
+}
+
+/**
+ * @brief Minimum of the member over a contiguous range of records.
+ * @tparam Name name of member
+ * @param range contiguous range of default-constructible aggregate type
+ * @param policy optional parallel policy
+ * @return The minimum, or `std::nullopt` if `range` is empty.
+ */
+template <conststr::cstr Name, std::ranges::contiguous_range R,
+          typename... Policy>
+auto min(R &&range, Policy... policy)
+    requires std::same_as<typename decltype(Name)::value_type, char>
+{
+    return min(column<Name>(range), policy...);
+}
+
+/**
+ * @brief Maximum of the member over a contiguous range of records.
+ * @tparam Name name of member
+ * @param range contiguous range of default-constructible aggregate type
+ * @param policy optional parallel policy
+ * @return The maximum, or `std::nullopt` if `range` is empty.
+ */
+template <conststr::cstr Name, std::ranges::contiguous_range R,
+          typename... Policy>
+auto max(R &&range, Policy... policy)
+    requires std::same_as<typename decltype(Name)::value_type, char>
+{
+    return max(column<Name>(range), policy...);
+}
+
+/**
+ * @brief Arithmetic mean of the member over a contiguous range of records.
+ * @tparam Name name of member
+ * @param range contiguous range of default-constructible aggregate type
+ * @param policy optional parallel policy
+ * @return The mean, or `std::nullopt` if `range` is empty.
+ */
+template <conststr::cstr Name, std::ranges::contiguous_range R,
+          typename... Policy>
+auto mean(R &&range, Policy... policy)
+    requires std::same_as<typename decltype(Name)::value_type, char>
+{
+    return mean(column<Name>(range), policy...);
+}
+
+/**
+ * @brief Count the records whose member satisfies predicate `pred`.
+ * @details
+ * For example, `reflect::count_if<"qty">(vec, [](int q) { return q > 100; })`.
+ * @tparam Name name of member
+ * @param range contiguous range of default-constructible aggregate type
+ * @param pred unary predicate on the member
+ * @param policy optional parallel policy
+ * @return Number of the matched records.
+ */
+template <conststr::cstr Name, std::ranges::contiguous_range R,
+          typename UnaryPredicate, typename... Policy>
+std::size_t count_if(R &&range, UnaryPredicate pred, Policy... policy)
+    requires std::same_as<typename decltype(Name)::value_type, char>
+{
+    return count_if(column<Name>(range), pred, policy...);
+}
+}  // namespace reflect
+
+#endif
@@ -0,0 +1,482 @@
+/* MIT License
+ *
+ * Copyright (c) 2024 Nichts Hsu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * @file buffer_view.hpp
+ * @brief Zero-copy typed views over raw bytes, based on reflection.
+ */
+
+#ifndef REFLECT_BUFFER_VIEW_HPP
+#define REFLECT_BUFFER_VIEW_HPP
+
+#include <cassert>
+#include <cstring>
+#include <iterator>
+#include <span>
+
+#include "../reflect.hpp"
+
+namespace reflect {
+/**
+ * @brief This concept is satisfied if `T` can be read from or written to raw
+ * bytes member by member.
+ * @tparam T any type
+ */
+template <typename T>
+concept bytes_mappable = reflectable<T> && std::is_trivially_copyable_v<T>;
+
+/**
+ * @brief Read-only typed view of an object of type `T` stored in raw bytes.
+ * @details
+ * Members are loaded on demand from their offset with `std::memcpy`, so the
+ * bytes do not need to be aligned and no deserialization happens before the
+ * first access. For example:
+ * @code{.cpp}
+ * struct Tick {
+ *     std::uint64_t ts;
+ *     double price;
+ * };
+ * reflect::buffer_view<Tick> view(bytes);
+ * double price = view.get<"price">();
+ * std::uint64_t ts = view.get<0>();
+ * @endcode
+ * @note The bytes must hold at least `sizeof(T)` bytes in the native layout
+ * of `T`. Compare `schema_hash<T>` before viewing bytes from elsewhere.
+ * @tparam T trivially copyable aggregate type
+ * @see mutable_buffer_view
+ */
+template <bytes_mappable T>
+class buffer_view {
+   public:
+    using value_type = T;
+    using byte_type = const std::byte;
+
+    /**
+     * @brief Construct a view over `bytes`.
+     * @param bytes raw bytes of the object, at least `sizeof(T)` bytes
+     */
+    constexpr explicit buffer_view(std::span<const std::byte> bytes) noexcept
+        : _data(bytes.data()) {
+        assert(bytes.size() >= sizeof(T));
+    }
+
+    /**
+     * @brief Load the N-th member.
+     * @tparam N index of member
+     * @return Copy of the member.
+     */
+    template <std::size_t N>
+    type_of<T, N> get() const noexcept
+        requires(!std::is_array_v<type_of<T, N>>)
+    {
+        type_of<T, N> value;
+        std::memcpy(&value, _data + offset_of<T, N>, sizeof(value));
+        return value;
+    }
+
+    /**
+     * @brief Load the `i`-th element of the N-th member which is an array.
+     * @tparam N index of member
+     * @param i index of element
+     * @return Copy of the element.
+     */
+    template <std::size_t N>
+    std::remove_extent_t<type_of<T, N>> get(std::size_t i) const noexcept
+        requires std::is_array_v<type_of<T, N>>
+    {
+        assert((i < std::extent_v<type_of<T, N>>));
+        std::remove_extent_t<type_of<T, N>> value;
+        std::memcpy(&value, _data + offset_of<T, N> + i * sizeof(value),
+                    sizeof(value));
+        return value;
+    }
+
+    /**
+     * @brief Load the member via its name.
+     * @tparam Name name of member
+     * @return Copy of the member.
+     */
+    template <conststr::cstr Name>
+    type_of_member<T, Name> get() const noexcept
+        requires std::same_as<typename decltype(Name)::value_type, char> &&
+                 (!std::is_array_v<type_of_member<T, Name>>)
+    {
+        return get<index_of<T, Name>>();
+    }
+
+    /**
+     * @brief Load the `i`-th element of the member which is an array via its name.
+     * @tparam Name name of member
+     * @param i index of element
+     * @return Copy of the element.
+     */
+    template <conststr::cstr Name>
+    std::remove_extent_t<type_of_member<T, Name>> get(
+        std::size_t i) const noexcept
+        requires std::same_as<typename decltype(Name)::value_type, char> &&
+                 std::is_array_v<type_of_member<T, Name>>
+    {
+        return get<index_of<T, Name>>(i);
+    }
+
+    /**
+     * @brief Get a view of the N-th member which is also an aggregate.
+     * @tparam N index of member
+     * @return View of the nested object.
+     */
+    template <std::size_t N>
+    buffer_view<type_of<T, N>> view() const noexcept
+        requires bytes_mappable<type_of<T, N>>
+    {
+        return buffer_view<type_of<T, N>>(
+            std::span(_data + offset_of<T, N>, sizeof(type_of<T, N>)));
+    }
+
+    /**
+     * @brief Get a view of the member which is also an aggregate via its name.
+     * @tparam Name name of member
+     * @return View of the nested object.
+     */
+    template <conststr::cstr Name>
+    auto view() const noexcept
+        requires std::same_as<typename decltype(Name)::value_type, char>
+    {
+        return view<index_of<T, Name>>();
+    }
+
+    /**
+     * @brief Load the whole object.
+     * @return Copy of the object.
+     */
+    T load() const noexcept {
+        T value;
+        std::memcpy(&value, _data, sizeof(T));
+        return value;
+    }
+
+    /**
+     * @brief Get the viewed bytes.
+     * @return Span of `sizeof(T)` bytes.
+     */
+    constexpr std::span<const std::byte, sizeof(T)> bytes() const noexcept {
+        return std::span<const std::byte, sizeof(T)>(_data, sizeof(T));
+    }
+
+   protected:
+    const std::byte *_data;
+};
+
+/**
+ * @brief Writable typed view of an object of type `T` stored in raw bytes.
+ * @details
+ * Same as `buffer_view` but members can also be stored in place:
+ * @code{.cpp}
+ * reflect::mutable_buffer_view<Tick> view(bytes);
+ * view.set<"price">(view.get<"price">() * 2);
+ * @endcode
+ * @tparam T trivially copyable aggregate type
+ * @see buffer_view
+ */
+template <bytes_mappable T>
+class mutable_buffer_view : public buffer_view<T> {
+   public:
+    /**
+     * @brief Construct a view over `bytes`.
+     * @param bytes raw bytes of the object, at least `sizeof(T)` bytes
+     */
+    constexpr explicit mutable_buffer_view(std::span<std::byte> bytes) noexcept
+        : buffer_view<T>(bytes), _bytes(bytes.data()) {}
+
+    /**
+     * @brief Store the N-th member.
+     * @tparam N index of member
+     * @param value new value of the member
+     */
+    template <std::size_t N>
+    void set(const type_of<T, N> &value) const noexcept {
+        std::memcpy(data() + offset_of<T, N>, &value, sizeof(value));
+    }
+
+    /**
+     * @brief Store the `i`-th element of the N-th member which is an array.
+     * @tparam N index of member
+     * @param i index of element
+     * @param value new value of the element
+     */
+    template <std::size_t N>
+    void set(std::size_t i,
+             const std::remove_extent_t<type_of<T, N>> &value) const noexcept
+        requires std::is_array_v<type_of<T, N>>
+    {
+        assert((i < std::extent_v<type_of<T, N>>));
+        std::memcpy(data() + offset_of<T, N> + i * sizeof(value), &value,
+                    sizeof(value));
+    }
+
+    /**
+     * @brief Store the member via its name.
+     * @tparam Name name of member
+     * @param value new value of the member
+     */
+    template <conststr::cstr Name>
+    void set(const type_of_member<T, Name> &value) const noexcept
+        requires std::same_as<typename decltype(Name)::value_type, char>
+    {
+        set<index_of<T, Name>>(value);
+    }
+
+    /**
+     * @brief Store the `i`-th element of the member which is an array via its name.
+     * @tparam Name name of member
+     * @param i index of element
+     * @param value new value of the element
+     */
+    template <conststr::cstr Name>
+    void set(std::size_t i,
+             const std::remove_extent_t<type_of_member<T, Name>> &value)
+        const noexcept
+        requires std::same_as<typename decltype(Name)::value_type, char> &&
+                 std::is_array_v<type_of_member<T, Name>>
+    {
+        set<index_of<T, Name>>(i, value);
+    }
+
+    /**
+     * @brief Get a writable view of the N-th member which is also an aggregate.
+     * @tparam N index of member
+     * @return Writable view of the nested object.
+     */
+    template <std::size_t N>
+    mutable_buffer_view<type_of<T, N>> view() const noexcept
+        requires bytes_mappable<type_of<T, N>>
+    {
+        return mutable_buffer_view<type_of<T, N>>(
+            std::span(data() + offset_of<T, N>, sizeof(type_of<T, N>)));
+    }
+
+    /**
+     * @brief Get a writable view of the member which is also an aggregate via its name.
+     * @tparam Name name of member
+     * @return Writable view of the nested object.
+     */
+    template <conststr::cstr Name>
+    auto view() const noexcept
+        requires std::same_as<typename decltype(Name)::value_type, char>
+    {
+        return view<index_of<T, Name>>();
+    }
+
+    /**
+     * @brief Store the whole object.
+     * @param value new value of the object
+     */
+    void store(const T &value) const noexcept {
+        std::memcpy(data(), &value, sizeof(T));
+    }
+
+    /**
+     * @brief Get the viewed bytes.
+     * @return Span of `sizeof(T)` bytes.
+     */
+    constexpr std::span<std::byte, sizeof(T)> bytes() const noexcept {
+        return std::span<std::byte, sizeof(T)>(data(), sizeof(T));
+    }
+
+   private:
+    constexpr std::byte *data() const noexcept { return _bytes; }
+
+    std::byte *_bytes;
+};
+
+/**
+ * @brief Random access view of elements which are a fixed number of bytes apart.
+ * @details
+ * Typically used as a view of one member over an array of records, where
+ * `stride` is `sizeof(T)`, or over a column of members, where `stride` is
+ * `sizeof(M)`. Like `buffer_view`, elements are loaded and stored with
+ * `std::memcpy`, so the bytes do not need to be aligned: reading an element
+ * gives a copy, and writing one goes through an `element_ref`.
+ * @tparam M type of the element, may be const-qualified, not an array
+ */
+template <typename M>
+class strided_view {
+    static_assert(!std::is_array_v<M>,
+                  "strided_view: element type must not be an array");
+    static_assert(std::is_trivially_copyable_v<M>,
+                  "strided_view: element type must be trivially copyable");
+
+    using byte_type =
+        std::conditional_t<std::is_const_v<M>, const std::byte, std::byte>;
+
+   public:
+    using value_type = std::remove_cv_t<M>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    /**
+     * @brief Writable reference to an element, which loads and stores its
+     * value with `std::memcpy`.
+     */
+    class element_ref {
+       public:
+        constexpr explicit element_ref(std::byte *ptr) noexcept : _ptr(ptr) {}
+        element_ref(const element_ref &) noexcept = default;
+
+        operator value_type() const noexcept {
+            value_type value;
+            std::memcpy(&value, _ptr, sizeof(value));
+            return value;
+        }
+
+        const element_ref &operator=(const value_type &value) const noexcept {
+            std::memcpy(_ptr, &value, sizeof(value));
+            return *this;
+        }
+
+        const element_ref &operator=(const element_ref &other) const noexcept {
+            return *this = value_type(other);
+        }
+
+       private:
+        std::byte *_ptr;
+    };
+
+    using reference =
+        std::conditional_t<std::is_const_v<M>, value_type, element_ref>;
+
+    /**
+     * @brief Random access iterator of `strided_view`.
+     */
+    class iterator {
+       public:
+        using iterator_concept = std::random_access_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type = std::remove_cv_t<M>;
+        using difference_type = std::ptrdiff_t;
+        using reference = strided_view::reference;
+
+        constexpr iterator() noexcept = default;
+        constexpr iterator(byte_type *ptr, std::size_t stride) noexcept
+            : _ptr(ptr), _stride(stride) {}
+
+        reference operator*() const noexcept { return load(_ptr); }
+        reference operator[](difference_type n) const noexcept {
+            return *(*this + n);
+        }
+        constexpr iterator &operator++() noexcept {
+            _ptr += _stride;
+            return *this;
+        }
+        constexpr iterator operator++(int) noexcept {
+            auto old = *this;
+            ++*this;
+            return old;
+        }
+        constexpr iterator &operator--() noexcept {
+            _ptr -= _stride;
+            return *this;
+        }
+        constexpr iterator operator--(int) noexcept {
+            auto old = *this;
+            --*this;
+            return old;
+        }
+        constexpr iterator &operator+=(difference_type n) noexcept {
+            _ptr += n * difference_type(_stride);
+            return *this;
+        }
+        constexpr iterator &operator-=(difference_type n) noexcept {
+            return *this += -n;
+        }
+        friend constexpr iterator operator+(iterator it,
+                                            difference_type n) noexcept {
+            return it += n;
+        }
+        friend constexpr iterator operator+(difference_type n,
+                                            iterator it) noexcept {
+            return it += n;
+        }
+        friend constexpr iterator operator-(iterator it,
+                                            difference_type n) noexcept {
+            return it -= n;
+        }
+        friend constexpr difference_type operator-(
+            const iterator &lhs, const iterator &rhs) noexcept {
+            return (lhs._ptr - rhs._ptr) / difference_type(lhs._stride);
+        }
+        friend constexpr bool operator==(const iterator &lhs,
+                                         const iterator &rhs) noexcept {
+            return lhs._ptr == rhs._ptr;
+        }
+        friend constexpr auto operator<=>(const iterator &lhs,
+                                          const iterator &rhs) noexcept {
+            return lhs._ptr <=> rhs._ptr;
+        }
+
+       private:
+        byte_type *_ptr = nullptr;
+        std::size_t _stride = 0;
+    };
+
+    /**
+     * @brief Construct a view of `count` elements `stride` bytes apart.
+     * @param first address of the first element
+     * @param stride distance between two elements in bytes
+     * @param count number of elements
+     */
+    constexpr strided_view(byte_type *first, std::size_t stride,
+                           std::size_t count) noexcept
+        : _first(first), _stride(stride), _count(count) {}
+
+    constexpr iterator begin() const noexcept {
+        return iterator(_first, _stride);
+    }
+    constexpr iterator end() const noexcept {
+        return iterator(_first + _stride * _count, _stride);
+    }
+    constexpr size_type size() const noexcept { return _count; }
+    constexpr bool empty() const noexcept { return _count == 0; }
+    constexpr size_type stride() const noexcept { return _stride; }
+    constexpr byte_type *data() const noexcept { return _first; }
+    reference operator[](size_type i) const noexcept {
+        return load(_first + _stride * i);
+    }
+
+   private:
+    static reference load(byte_type *ptr) noexcept {
+        if constexpr (std::is_const_v<M>) {
+            value_type value;
+            std::memcpy(&value, ptr, sizeof(value));
+            return value;
+        } else {
+            return element_ref(ptr);
+        }
+    }
+
+    byte_type *_first;
+    std::size_t _stride;
+    std::size_t _count;
+};
+}  // namespace reflect
+
+#endif
@@ -0,0 +1,564 @@
+/* MIT License
+ *
+ * Copyright (c) 2024 Nichts Hsu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * @file compact.hpp
+ * @brief Protobuf-style compact binary encoding of reflected records.
+ */
+
+#ifndef REFLECT_COMPACT_HPP
+#define REFLECT_COMPACT_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "../reflect.hpp"
+
+namespace reflect {
+/**
+ * @brief Compact binary encoding of reflected records.
+ * @details
+ * The wire format follows protocol buffers: every member is written as a
+ * varint key `(tag << 3) | wire_type` followed by its value. Unsigned
+ * integers, enumerations and `bool` are varints, signed integers are
+ * zigzag varints, `float` and `double` are little-endian fixed32 and fixed64,
+ * strings and nested records are length-delimited. A plain `char` is the
+ * varint of its value as `unsigned char`, whatever its signedness on the
+ * platform. A `char[N]` member holds a string of at most N characters,
+ * terminated by `'\0'` if shorter. Members equal to their value-initialized
+ * state are omitted.
+ *
+ * By default the tag of a member is its index plus one. Tags can be assigned
+ * by name through a specialization of `compact::tags`:
+ * @code{.cpp}
+ * struct Sample { int id; float temp; };
+ * template <>
+ * struct reflect::compact::tags<Sample>
+ *     : reflect::compact::tag_map<reflect::compact::tag<"temp", 7>> {};
+ * @endcode
+ */
+namespace compact {
+/**
+ * @brief Wire type in the low three bits of every key.
+ */
+enum class wire_type : std::uint8_t {
+    varint = 0,
+    fixed64 = 1,
+    length_delimited = 2,
+    fixed32 = 5,
+};
+
+/**
+ * @brief Assign the tag `Tag` to the member named `Name`.
+ */
+template <conststr::cstr Name, std::uint32_t Tag>
+struct tag {
+    static constexpr auto name = Name;
+    static constexpr std::uint32_t value = Tag;
+};
+
+/**
+ * @brief Compile-time map from member names to tags.
+ * @tparam Tags list of `tag`
+ */
+template <typename... Tags>
+struct tag_map {
+    /**
+     * @brief Get the tag of the member `Name`, or 0 if it is not mapped.
+     */
+    template <conststr::cstr Name>
+    static constexpr std::uint32_t find() noexcept {
+        std::uint32_t result = 0;
+        static_cast<void>(
+            ((Tags::name == Name ? (result = Tags::value, true) : false) ||
+             ...));
+        return result;
+    }
+};
+
+/**
+ * @brief Tags of the members of `T`, specialize it to assign tags by name.
+ */
+template <typename T>
+struct tags : tag_map<> {};
+
+/**
+ * @brief Tag of the I-th member of `T`.
+ */
+template <typename T, std::size_t I>
+constexpr std::uint32_t tag_of = [] {
+    constexpr std::uint32_t mapped =
+        tags<T>::template find<name_of<T, I>>();
+    return mapped != 0 ? mapped : std::uint32_t(I + 1);
+}();
+
+/**
+ * @brief Internal implementation of `compact`.
+ * Whether `M` is a fixed-size character buffer.
+ */
+template <typename M>
+constexpr bool is_char_array =
+    std::is_bounded_array_v<M> &&
+    std::is_same_v<std::remove_cv_t<std::remove_extent_t<M>>, char>;
+
+/**
+ * @brief Internal implementation of `compact`.
+ * Wire type used to encode the type `M`.
+ */
+template <typename M>
+constexpr wire_type wire_type_of() {
+    if constexpr (std::is_same_v<M, float>)
+        return wire_type::fixed32;
+    else if constexpr (std::is_same_v<M, double>)
+        return wire_type::fixed64;
+    else if constexpr (std::is_integral_v<M> || std::is_enum_v<M>)
+        return wire_type::varint;
+    else if constexpr (std::is_pointer_v<M>)
+        static_assert(!sizeof(M), "pointers cannot be decoded by compact");
+    else if constexpr (is_char_array<M> ||
+                       std::is_convertible_v<const M &, std::string_view> ||
+                       reflectable<M>)
+        return wire_type::length_delimited;
+    else
+        static_assert(!sizeof(M), "type is not supported by compact");
+}
+
+/**
+ * @brief Internal implementation of `compact`.
+ * Characters of a string member, a `char[N]` stops at its first `'\0'`.
+ */
+template <typename M>
+constexpr std::string_view string_of(const M &value) {
+    if constexpr (is_char_array<M>)
+        return std::string_view(
+            value, std::find(std::begin(value), std::end(value), '\0'));
+    else
+        return std::string_view(value);
+}
+
+/**
+ * @brief Varint bytes of a value known at compile time.
+ */
+struct varint_bytes {
+    std::array<std::byte, 10> data{};
+    std::size_t size = 0;
+
+    constexpr explicit varint_bytes(std::uint64_t value) {
+        while (value >= 0x80) {
+            data[size++] = std::byte((value & 0x7F) | 0x80);
+            value >>= 7;
+        }
+        data[size++] = std::byte(value);
+    }
+};
+
+/**
+ * @brief Precomputed key bytes of the I-th member of `T`.
+ */
+template <typename T, std::size_t I>
+constexpr varint_bytes key_of{
+    (std::uint64_t(tag_of<T, I>) << 3) |
+    std::uint64_t(wire_type_of<type_of<T, I>>())};
+
+/**
+ * @brief Append the varint encoding of `value` to `out`.
+ */
+inline void put_varint(std::vector<std::byte> &out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(std::byte((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(std::byte(value));
+}
+
+/**
+ * @brief Get the number of bytes in the varint encoding of `value`.
+ */
+constexpr std::size_t varint_size(std::uint64_t value) noexcept {
+    return (std::bit_width(value | 1) + 6) / 7;
+}
+
+/**
+ * @brief Map a signed integer to an unsigned one with small magnitude.
+ */
+constexpr std::uint64_t zigzag(std::int64_t value) noexcept {
+    return (std::uint64_t(value) << 1) ^ std::uint64_t(value >> 63);
+}
+
+/**
+ * @brief Inverse of `zigzag`.
+ */
+constexpr std::int64_t unzigzag(std::uint64_t value) noexcept {
+    return std::int64_t(value >> 1) ^ -std::int64_t(value & 1);
+}
+
+/**
+ * @brief Internal implementation of `compact`.
+ * Varint payload of an integral, enumeration or `bool` member.
+ */
+template <typename M>
+constexpr std::uint64_t to_varint(const M &value) noexcept {
+    if constexpr (std::is_enum_v<M>)
+        return to_varint(std::underlying_type_t<M>(value));
+    else if constexpr (std::is_same_v<M, char>)
+        return static_cast<unsigned char>(value);
+    else if constexpr (std::is_signed_v<M>)
+        return zigzag(std::int64_t(value));
+    else
+        return std::uint64_t(value);
+}
+
+/**
+ * @brief Internal implementation of `compact`.
+ * Whether a member value other than a nested record is omitted from the
+ * encoding.
+ */
+template <typename M>
+bool is_empty(const M &value) {
+    if constexpr (wire_type_of<M>() != wire_type::length_delimited)
+        return value == M{};
+    else
+        return string_of(value).empty();
+}
+
+/**
+ * @brief Internal implementation of `compact`.
+ * Number of bytes of a member value other than a nested record, without its
+ * key.
+ */
+template <typename M>
+std::size_t value_size(const M &value) {
+    if constexpr (wire_type_of<M>() == wire_type::fixed32)
+        return 4;
+    else if constexpr (wire_type_of<M>() == wire_type::fixed64)
+        return 8;
+    else if constexpr (wire_type_of<M>() == wire_type::varint)
+        return varint_size(to_varint(value));
+    else {
+        std::size_t size = string_of(value).size();
+        return varint_size(size) + size;
+    }
+}
+
+/**
+ * @brief Internal implementation of `compact`.
+ * Get the number of bytes `encode` appends for `obj`.
+ * @details
+ * Nested records are measured once: the size of each one is appended to
+ * `sizes` in the order `put_record` visits them, and a record omitted for
+ * being empty leaves a single zero without entries for its own members.
+ */
+template <reflectable T>
+std::size_t measure(const T &obj, std::vector<std::size_t> &sizes) {
+    auto member_size = [&]<typename M>(const M &value) -> std::size_t {
+        if constexpr (reflectable<M>) {
+            const std::size_t slot = sizes.size();
+            sizes.push_back(0);
+            const std::size_t size = measure(value, sizes);
+            if (size == 0) {
+                sizes.resize(slot + 1);
+                return 0;
+            }
+            sizes[slot] = size;
+            return varint_size(size) + size;
+        } else {
+            return is_empty(value) ? 0 : value_size(value);
+        }
+    };
+    return [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+        return (std::size_t(0) + ... + [&] {
+            std::size_t size = member_size(member_of<Is>(obj));
+            return size == 0 ? 0 : key_of<T, Is>.size + size;
+        }());
+    }(std::make_index_sequence<number_of_members<T>>{});
+}
+
+/**
+ * @brief Get the number of bytes `encode` appends for `obj`.
+ */
+template <reflectable T>
+std::size_t encoded_size(const T &obj) {
+    std::vector<std::size_t> sizes;
+    return measure(obj, sizes);
+}
+
+/**
+ * @brief Internal implementation of `compact`.
+ * Append a member value other than a nested record, without its key.
+ */
+template <typename M>
+void put_value(std::vector<std::byte> &out, const M &value) {
+    if constexpr (wire_type_of<M>() == wire_type::fixed32 ||
+                  wire_type_of<M>() == wire_type::fixed64) {
+        using U = std::conditional_t<sizeof(M) == 4, std::uint32_t,
+                                     std::uint64_t>;
+        U bits = std::bit_cast<U>(value);
+        for (std::size_t i = 0; i < sizeof(U); ++i)
+            out.push_back(std::byte(bits >> (8 * i)));
+    } else if constexpr (wire_type_of<M>() == wire_type::varint) {
+        put_varint(out, to_varint(value));
+    } else {
+        std::string_view str = string_of(value);
+        put_varint(out, str.size());
+        const auto *bytes = reinterpret_cast<const std::byte *>(str.data());
+        out.insert(out.end(), bytes, bytes + str.size());
+    }
+}
+
+/**
+ * @brief Internal implementation of `compact`.
+ * Append the members of `obj`, taking the sizes of nested records from
+ * `sizes` as computed by `measure`.
+ */
+template <reflectable T>
+void put_record(const T &obj, std::vector<std::byte> &out,
+                const std::size_t *&sizes) {
+    [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+        (
+            [&] {
+                const auto &value = member_of<Is>(obj);
+                constexpr const auto &key = key_of<T, Is>;
+                if constexpr (reflectable<type_of<T, Is>>) {
+                    std::size_t size = *sizes++;
+                    if (size == 0) return;
+                    out.insert(out.end(), key.data.begin(),
+                               key.data.begin() + key.size);
+                    put_varint(out, size);
+                    put_record(value, out, sizes);
+                } else {
+                    if (is_empty(value)) return;
+                    out.insert(out.end(), key.data.begin(),
+                               key.data.begin() + key.size);
+                    put_value(out, value);
+                }
+            }(),
+            ...);
+    }(std::make_index_sequence<number_of_members<T>>{});
+}
+
+/**
+ * @brief Append the compact encoding of `obj` to `out`.
+ * @param obj object of default-constructible aggregate type
+ * @param out output buffer
+ */
+template <reflectable T>
+void encode(const T &obj, std::vector<std::byte> &out) {
+    std::vector<std::size_t> sizes;
+    out.reserve(out.size() + measure(obj, sizes));
+    const std::size_t *next = sizes.data();
+    put_record(obj, out, next);
+}
+
+/**
+ * @brief Get the compact encoding of `obj`.
+ * @param obj object of default-constructible aggregate type
+ * @return Encoded bytes.
+ */
+template <reflectable T>
+std::vector<std::byte> encode(const T &obj) {
+    std::vector<std::byte> out;
+    encode(obj, out);
+    return out;
+}
+
+/**
+ * @brief Internal implementation of `compact`.
+ * Cursor over the input of `decode`.
+ */
+struct reader {
+    const std::byte *pos;
+    const std::byte *end;
+
+    [[noreturn]] static void fail(const char *what) {
+        throw std::runtime_error(std::string("compact: ") + what);
+    }
+
+    std::uint64_t varint() {
+        std::uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (pos == end) fail("truncated varint");
+            std::uint64_t byte = std::uint64_t(*pos++);
+            value |= (byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+        fail("varint too long");
+    }
+
+    std::span<const std::byte> take(std::size_t size) {
+        if (std::size_t(end - pos) < size) fail("truncated field");
+        std::span<const std::byte> bytes(pos, size);
+        pos += size;
+        return bytes;
+    }
+
+    void skip(wire_type type) {
+        switch (type) {
+            case wire_type::varint:
+                varint();
+                break;
+            case wire_type::fixed64:
+                take(8);
+                break;
+            case wire_type::length_delimited:
+                take(varint());
+                break;
+            case wire_type::fixed32:
+                take(4);
+                break;
+            default:
+                fail("unknown wire type");
+        }
+    }
+};
+
+template <reflectable T>
+T decode(std::span<const std::byte> bytes);
+
+/**
+ * @brief Internal implementation of `compact`.
+ * Read a member value whose key has been consumed.
+ */
+template <typename M>
+void get_value(reader &in, M &value) {
+    if constexpr (wire_type_of<M>() == wire_type::fixed32 ||
+                  wire_type_of<M>() == wire_type::fixed64) {
+        using U = std::conditional_t<sizeof(M) == 4, std::uint32_t,
+                                     std::uint64_t>;
+        auto bytes = in.take(sizeof(U));
+        U bits = 0;
+        for (std::size_t i = 0; i < sizeof(U); ++i)
+            bits |= U(bytes[i]) << (8 * i);
+        value = std::bit_cast<M>(bits);
+    } else if constexpr (std::is_same_v<M, bool>) {
+        value = in.varint() != 0;
+    } else if constexpr (std::is_enum_v<M>) {
+        std::underlying_type_t<M> raw;
+        get_value(in, raw);
+        value = M(raw);
+    } else if constexpr (std::is_same_v<M, char>) {
+        unsigned char raw;
+        get_value(in, raw);
+        value = char(raw);
+    } else if constexpr (std::is_integral_v<M>) {
+        using limits = std::numeric_limits<M>;
+        std::uint64_t raw = in.varint();
+        if constexpr (std::is_signed_v<M>) {
+            std::int64_t signed_raw = unzigzag(raw);
+            if (signed_raw < limits::min() || signed_raw > limits::max())
+                in.fail("integer out of range");
+            value = M(signed_raw);
+        } else {
+            if (raw > limits::max()) in.fail("integer out of range");
+            value = M(raw);
+        }
+    } else if constexpr (reflectable<M>) {
+        value = decode<M>(in.take(in.varint()));
+    } else if constexpr (is_char_array<M>) {
+        auto bytes = in.take(in.varint());
+        if (bytes.size() > std::extent_v<M>) in.fail("string too long");
+        std::fill(std::begin(value), std::end(value), '\0');
+        std::memcpy(value, bytes.data(), bytes.size());
+    } else {
+        auto bytes = in.take(in.varint());
+        value = M(std::string_view(reinterpret_cast<const char *>(bytes.data()),
+                                   bytes.size()));
+    }
+}
+
+/**
+ * @brief Internal implementation of `compact`.
+ * Decoder of one member, entry of the jump table.
+ */
+template <typename T>
+using field_decoder = void (*)(reader &, T &, wire_type);
+
+/**
+ * @brief Internal implementation of `compact`.
+ * Jump table from tags to member decoders.
+ */
+template <typename T>
+constexpr auto decoders = [] {
+    constexpr std::uint32_t max_tag =
+        []<std::size_t... Is>(std::index_sequence<Is...>) {
+            return std::max({std::uint32_t(0), tag_of<T, Is>...});
+        }(std::make_index_sequence<number_of_members<T>>{});
+    static_assert(max_tag < 4096, "compact tags must be less than 4096");
+
+    std::array<field_decoder<T>, max_tag + 1> table{};
+    [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+        (
+            [&] {
+                if (table[tag_of<T, Is>] != nullptr)
+                    throw "duplicate compact tag";
+                table[tag_of<T, Is>] = [](reader &in, T &obj, wire_type type) {
+                    if (type != wire_type_of<type_of<T, Is>>())
+                        in.skip(type);
+                    else
+                        get_value(in, member_of<Is>(obj));
+                };
+            }(),
+            ...);
+    }(std::make_index_sequence<number_of_members<T>>{});
+    return table;
+}();
+
+/**
+ * @brief Decode a record from its compact encoding.
+ * @details
+ * Missing members are value-initialized. Unknown tags and members with a
+ * mismatched wire type are skipped.
+ * @tparam T default-constructible aggregate type
+ * @param bytes encoded bytes
+ * @return Decoded record.
+ * @exception std::runtime_error if `bytes` is malformed.
+ */
+template <reflectable T>
+T decode(std::span<const std::byte> bytes) {
+    T obj{};
+    reader in{bytes.data(), bytes.data() + bytes.size()};
+    while (in.pos != in.end) {
+        std::uint64_t key = in.varint();
+        auto type = wire_type(key & 7);
+        std::uint64_t tag = key >> 3;
+        if (tag < decoders<T>.size() && decoders<T>[tag] != nullptr)
+            decoders<T>[tag](in, obj, type);
+        else
+            in.skip(type);
+    }
+    return obj;
+}
+}  // namespace compact
+}  // namespace reflect
+
+#endif
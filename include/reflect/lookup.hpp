@@ -0,0 +1,121 @@
+/* MIT License
+ *
+ * Copyright (c) 2024 Nichts Hsu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * @file lookup.hpp
+ * @brief Compile-time perfect hash from member names to member indices.
+ */
+
+#ifndef REFLECT_LOOKUP_HPP
+#define REFLECT_LOOKUP_HPP
+
+#include <array>
+#include <string_view>
+#include <utility>
+
+#include "../conststr/static_map.hpp"
+#include "../reflect.hpp"
+
+namespace reflect {
+/**
+ * @brief Perfect hash from N strings to integers.
+ * @see conststr::perfect_hash
+ */
+template <std::size_t N>
+using perfect_hash = conststr::perfect_hash<N>;
+
+/**
+ * @brief Former name `Old` of the member currently named `Name`.
+ */
+template <conststr::cstr Old, conststr::cstr Name>
+struct alias {
+    static constexpr auto old_name = Old;
+    static constexpr auto name = Name;
+};
+
+/**
+ * @brief Compile-time list of `alias`.
+ * @tparam Aliases list of `alias`
+ */
+template <typename... Aliases>
+struct alias_map {
+    /**
+     * @brief Number of aliases.
+     */
+    static constexpr std::size_t size = sizeof...(Aliases);
+
+    /**
+     * @brief Pairs of former name and current member index in `T`.
+     */
+    template <typename T>
+    static consteval auto entries() {
+        return std::array<std::pair<std::string_view, std::size_t>, size>{
+            std::pair{std::string_view(Aliases::old_name),
+                      index_of<T, Aliases::name>}...};
+    }
+};
+
+/**
+ * @brief Former member names of `T`, specialize it to decode old payloads.
+ * @details
+ * For example, after renaming `User::uid` to `User::id`:
+ * @code{.cpp}
+ * template <>
+ * struct reflect::aliases<User>
+ *     : reflect::alias_map<reflect::alias<"uid", "id">> {};
+ * @endcode
+ * Readers using `member_lookup` then accept both names.
+ */
+template <typename T>
+struct aliases : alias_map<> {};
+
+/**
+ * @brief Internal implementation of `member_lookup`.
+ */
+template <typename T>
+consteval auto member_lookup_impl() {
+    constexpr std::size_t n = number_of_members<T>;
+    constexpr std::size_t total = n + aliases<T>::size;
+    std::array<std::pair<std::string_view, std::size_t>, total> entries;
+    [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+        ((entries[Is] = {std::string_view(name_of<T, Is>), Is}), ...);
+    }(std::make_index_sequence<n>{});
+    auto old_names = aliases<T>::template entries<T>();
+    for (std::size_t i = 0; i < old_names.size(); ++i)
+        entries[n + i] = old_names[i];
+    return perfect_hash<total>(entries);
+}
+
+/**
+ * @brief Perfect hash from member names of `T` to member indices.
+ * @details
+ * For example, `reflect::member_lookup<T>.find("id")` gives the index of the
+ * member `id`, or `perfect_hash<N>::npos` if `T` has no such member.
+ * Former names declared by `aliases<T>` are in the same table, so looking
+ * them up costs the same as current names.
+ */
+template <typename T>
+constexpr auto member_lookup = member_lookup_impl<T>();
+}  // namespace reflect
+
+#endif
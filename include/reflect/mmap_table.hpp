@@ -0,0 +1,513 @@
+/* MIT License
+ *
+ * Copyright (c) 2024 Nichts Hsu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * @file mmap_table.hpp
+ * @brief File-backed table of fixed-size reflected records.
+ * @note Requires POSIX `mmap`.
+ */
+
+#ifndef REFLECT_MMAP_TABLE_HPP
+#define REFLECT_MMAP_TABLE_HPP
+
+#if defined(_WIN32)
+#error "reflect/mmap_table.hpp requires POSIX mmap."
+#endif
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#include "buffer_view.hpp"
+
+namespace reflect {
+/**
+ * @brief On-disk layout of `mmap_table`.
+ */
+enum class table_layout : std::uint64_t {
+    /**
+     * @brief Records are stored one after another, like `T[]`.
+     */
+    rows = 0,
+    /**
+     * @brief Each member is stored contiguously, like one array per member.
+     */
+    columns = 1,
+};
+
+/**
+ * @brief Header at the beginning of a `mmap_table` file.
+ * @details
+ * The data following the header starts at offset `mmap_table_header::size`.
+ */
+struct mmap_table_header {
+    /**
+     * @brief Size of the header region, also the alignment of every column.
+     */
+    static constexpr std::size_t size = 64;
+
+    /**
+     * @brief Magic bytes identifying the file format.
+     */
+    static constexpr std::array<char, 8> file_magic = {'C', 'S', 'T', 'R',
+                                                       'T', 'B', 'L', '\1'};
+
+    std::array<char, 8> magic;
+    std::uint64_t schema;
+    std::uint64_t record_size;
+    table_layout layout;
+    std::uint64_t rows;
+    std::uint64_t capacity;
+};
+
+/**
+ * @brief File-backed table of trivially copyable reflected records.
+ * @details
+ * The file starts with a `mmap_table_header` containing `schema_hash<T>`, so
+ * a file written for a different layout of `T` is refused when opened.
+ * Records are accessed in place through `mmap`, without parsing or heap
+ * allocation. For example:
+ * @code{.cpp}
+ * struct Tick {
+ *     std::uint64_t ts;
+ *     double price;
+ * };
+ *
+ * auto table = reflect::mmap_table<Tick>::create("ticks.tbl");
+ * table.append({1, 9.5});
+ *
+ * double sum = 0;
+ * for (double price : table.column<"price">()) sum += price;
+ * @endcode
+ * With `table_layout::columns`, each member is stored contiguously, which is
+ * faster when scanning a few members of wide records.
+ * @note Appending may remap the file, this invalidates all references,
+ * views and iterators, the same as `std::vector`.
+ * @tparam T trivially copyable aggregate type
+ */
+template <bytes_mappable T>
+class mmap_table {
+    static_assert(alignof(T) <= mmap_table_header::size);
+
+    static constexpr std::size_t members = number_of_members<T>;
+
+    static constexpr auto member_sizes =
+        []<std::size_t... Is>(std::index_sequence<Is...>) {
+            return std::array<std::size_t, members>{sizeof(type_of<T, Is>)...};
+        }(std::make_index_sequence<members>{});
+
+    static constexpr std::size_t align_up(std::size_t n) noexcept {
+        constexpr std::size_t align = mmap_table_header::size;
+        return (n + align - 1) / align * align;
+    }
+
+    // the largest capacity whose file size cannot overflow in any layout
+    static constexpr std::size_t max_capacity =
+        (std::numeric_limits<std::size_t>::max() -
+         mmap_table_header::size * (members + 1)) /
+        sizeof(T);
+
+   public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    /**
+     * @brief Create a new table file, truncating it if it exists.
+     * @param path path of the file
+     * @param layout on-disk layout of records
+     * @param capacity number of records to reserve
+     * @return Table opened for reading and writing.
+     * @exception std::system_error if the file cannot be created or mapped.
+     */
+    static mmap_table create(const char *path,
+                             table_layout layout = table_layout::rows,
+                             size_type capacity = 1024) {
+        int fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) throw_errno("open");
+        mmap_table table(fd, true, layout);
+        table.resize_file(std::max<size_type>(capacity, 1));
+        mmap_table_header &header = table.header();
+        header.magic = mmap_table_header::file_magic;
+        header.schema = schema_hash<T>;
+        header.record_size = sizeof(T);
+        header.layout = layout;
+        header.rows = 0;
+        header.capacity = table._capacity;
+        return table;
+    }
+
+    /**
+     * @brief Open an existing table file.
+     * @param path path of the file
+     * @param writable open for appending and updating records if `true`
+     * @return The opened table.
+     * @exception std::system_error if the file cannot be opened or mapped.
+     * @exception std::runtime_error if the file is not a table of `T` or its
+     * header is corrupt.
+     */
+    static mmap_table open(const char *path, bool writable = false) {
+        int fd = ::open(path, writable ? O_RDWR : O_RDONLY);
+        if (fd < 0) throw_errno("open");
+        mmap_table table(fd, writable, table_layout::rows);
+        struct stat st;
+        if (::fstat(fd, &st) < 0) throw_errno("fstat");
+        if (size_type(st.st_size) < mmap_table_header::size)
+            throw std::runtime_error("mmap_table: file too small");
+        table.map(size_type(st.st_size));
+        const mmap_table_header &header = table.header();
+        if (header.magic != mmap_table_header::file_magic)
+            throw std::runtime_error("mmap_table: not a table file");
+        if (header.schema != schema_hash<T> ||
+            header.record_size != sizeof(T))
+            throw std::runtime_error("mmap_table: schema mismatch");
+        if ((header.layout != table_layout::rows &&
+             header.layout != table_layout::columns) ||
+            header.capacity > max_capacity ||
+            header.rows > header.capacity)
+            throw std::runtime_error("mmap_table: corrupt header");
+        table._layout = header.layout;
+        table._capacity = size_type(header.capacity);
+        if (table.file_size(table._capacity) > table._mapped)
+            throw std::runtime_error("mmap_table: file truncated");
+        return table;
+    }
+
+    mmap_table(const mmap_table &) = delete;
+    mmap_table &operator=(const mmap_table &) = delete;
+
+    mmap_table(mmap_table &&other) noexcept
+        : _fd(std::exchange(other._fd, -1)),
+          _writable(other._writable),
+          _layout(other._layout),
+          _base(std::exchange(other._base, nullptr)),
+          _mapped(std::exchange(other._mapped, 0)),
+          _capacity(std::exchange(other._capacity, 0)) {}
+
+    mmap_table &operator=(mmap_table &&other) noexcept {
+        if (this != &other) {
+            close();
+            _fd = std::exchange(other._fd, -1);
+            _writable = other._writable;
+            _layout = other._layout;
+            _base = std::exchange(other._base, nullptr);
+            _mapped = std::exchange(other._mapped, 0);
+            _capacity = std::exchange(other._capacity, 0);
+        }
+        return *this;
+    }
+
+    ~mmap_table() { close(); }
+
+    /**
+     * @brief Get the number of records.
+     */
+    size_type size() const noexcept { return size_type(header().rows); }
+
+    /**
+     * @brief Check if the table has no records.
+     */
+    bool empty() const noexcept { return size() == 0; }
+
+    /**
+     * @brief Get the number of records that can be held without remapping.
+     */
+    size_type capacity() const noexcept { return _capacity; }
+
+    /**
+     * @brief Get the on-disk layout of records.
+     */
+    table_layout layout() const noexcept { return _layout; }
+
+    /**
+     * @brief Check if the table was opened for writing.
+     */
+    bool writable() const noexcept { return _writable; }
+
+    /**
+     * @brief Get all records in place.
+     * @return Span of all records.
+     * @exception std::runtime_error if the layout is not `table_layout::rows`.
+     */
+    std::span<const T> rows() const {
+        check_rows();
+        return {reinterpret_cast<const T *>(data()), size()};
+    }
+
+    /**
+     * @brief Get all records in place.
+     * @return Span of all records.
+     * @exception std::runtime_error if the layout is not `table_layout::rows`
+     * or the table is not writable.
+     */
+    std::span<T> rows() {
+        check_rows();
+        check_writable();
+        return {reinterpret_cast<T *>(data()), size()};
+    }
+
+    /**
+     * @brief Get a view over the N-th member of all records.
+     * @tparam N index of member
+     * @return Random access view of the member.
+     */
+    template <std::size_t N>
+    strided_view<const type_of<T, N>> column() const noexcept {
+        return {data() + column_offset<N>(), column_stride<N>(), size()};
+    }
+
+    /**
+     * @brief Get a writable view over the N-th member of all records.
+     * @tparam N index of member
+     * @return Random access view of the member.
+     * @exception std::runtime_error if the table is not writable.
+     */
+    template <std::size_t N>
+    strided_view<type_of<T, N>> column() {
+        check_writable();
+        return {data() + column_offset<N>(), column_stride<N>(), size()};
+    }
+
+    /**
+     * @brief Get a view over the member of all records via its name.
+     * @tparam Name name of member
+     * @return Random access view of the member.
+     */
+    template <conststr::cstr Name>
+    auto column() const noexcept
+        requires std::same_as<typename decltype(Name)::value_type, char>
+    {
+        return column<index_of<T, Name>>();
+    }
+
+    /**
+     * @brief Get a writable view over the member of all records via its name.
+     * @tparam Name name of member
+     * @return Random access view of the member.
+     * @exception std::runtime_error if the table is not writable.
+     */
+    template <conststr::cstr Name>
+    auto column()
+        requires std::same_as<typename decltype(Name)::value_type, char>
+    {
+        return column<index_of<T, Name>>();
+    }
+
+    /**
+     * @brief Load the `row`-th record.
+     * @param row index of record
+     * @return Copy of the record.
+     */
+    T load(size_type row) const noexcept {
+        if (_layout == table_layout::rows) return rows()[row];
+        T value;
+        [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            (std::memcpy(&member_of<Is>(value), member_at<Is>(row),
+                         member_sizes[Is]),
+             ...);
+        }(std::make_index_sequence<members>{});
+        return value;
+    }
+
+    /**
+     * @brief Store the `row`-th record.
+     * @param row index of record
+     * @param value new value of the record
+     * @exception std::runtime_error if the table is not writable.
+     */
+    void store(size_type row, const T &value) {
+        check_writable();
+        if (_layout == table_layout::rows) {
+            rows()[row] = value;
+            return;
+        }
+        [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            (store_member<Is>(row, member_of<Is>(value)), ...);
+        }(std::make_index_sequence<members>{});
+    }
+
+    /**
+     * @brief Append a record, growing the file if needed.
+     * @param value the record to append
+     * @exception std::system_error if the file cannot be grown or remapped.
+     * @exception std::runtime_error if the table is not writable.
+     */
+    void append(const T &value) {
+        check_writable();
+        size_type row = size();
+        if (row == _capacity) reserve(_capacity * 2);
+        header().rows = row + 1;
+        store(row, value);
+    }
+
+    /**
+     * @brief Grow the file so that it can hold at least `capacity` records.
+     * @param capacity number of records to reserve
+     * @exception std::system_error if the file cannot be grown or remapped.
+     * @exception std::runtime_error if the table is not writable.
+     */
+    void reserve(size_type capacity) {
+        check_writable();
+        if (capacity <= _capacity) return;
+        std::array<size_type, members> old_offsets = column_offsets();
+        resize_file(capacity);
+        if (_layout == table_layout::columns) {
+            std::array<size_type, members> new_offsets = column_offsets();
+            for (size_type i = members; i-- > 1;)
+                std::memmove(data() + new_offsets[i], data() + old_offsets[i],
+                             size() * member_sizes[i]);
+        }
+        header().capacity = _capacity;
+    }
+
+    /**
+     * @brief Flush modified pages to the file synchronously.
+     * @exception std::system_error if `msync` fails.
+     */
+    void flush() {
+        if (_base && ::msync(_base, _mapped, MS_SYNC) < 0) throw_errno("msync");
+    }
+
+   private:
+    mmap_table(int fd, bool writable, table_layout layout) noexcept
+        : _fd(fd), _writable(writable), _layout(layout) {}
+
+    [[noreturn]] static void throw_errno(const char *what) {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    void check_writable() const {
+        if (!_writable) throw std::runtime_error("mmap_table: not writable");
+    }
+
+    void check_rows() const {
+        if (_layout != table_layout::rows)
+            throw std::runtime_error("mmap_table: not a rows table");
+    }
+
+    mmap_table_header &header() noexcept {
+        return *reinterpret_cast<mmap_table_header *>(_base);
+    }
+
+    const mmap_table_header &header() const noexcept {
+        return *reinterpret_cast<const mmap_table_header *>(_base);
+    }
+
+    std::byte *data() noexcept { return _base + mmap_table_header::size; }
+
+    const std::byte *data() const noexcept {
+        return _base + mmap_table_header::size;
+    }
+
+    std::array<size_type, members> column_offsets() const noexcept {
+        std::array<size_type, members> offsets{};
+        [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            ((offsets[Is] = column_offset<Is>()), ...);
+        }(std::make_index_sequence<members>{});
+        return offsets;
+    }
+
+    template <std::size_t N>
+    size_type column_offset() const noexcept {
+        if (_layout == table_layout::rows) return offset_of<T, N>;
+        size_type offset = 0;
+        for (size_type i = 0; i < N; ++i)
+            offset += align_up(_capacity * member_sizes[i]);
+        return offset;
+    }
+
+    template <std::size_t N>
+    size_type column_stride() const noexcept {
+        return _layout == table_layout::rows ? sizeof(T) : member_sizes[N];
+    }
+
+    template <std::size_t N>
+    std::byte *member_at(size_type row) noexcept {
+        return data() + column_offset<N>() + row * column_stride<N>();
+    }
+
+    template <std::size_t N>
+    const std::byte *member_at(size_type row) const noexcept {
+        return data() + column_offset<N>() + row * column_stride<N>();
+    }
+
+    template <std::size_t N>
+    void store_member(size_type row, const type_of<T, N> &value) {
+        std::memcpy(member_at<N>(row), &value, sizeof(value));
+    }
+
+    size_type file_size(size_type capacity) const noexcept {
+        size_type size = mmap_table_header::size;
+        if (_layout == table_layout::rows) return size + capacity * sizeof(T);
+        for (size_type member_size : member_sizes)
+            size += align_up(capacity * member_size);
+        return size;
+    }
+
+    void resize_file(size_type capacity) {
+        size_type size = file_size(capacity);
+        if (::ftruncate(_fd, off_t(size)) < 0) throw_errno("ftruncate");
+        map(size);
+        _capacity = capacity;
+    }
+
+    void map(size_type size) {
+        unmap();
+        int prot = PROT_READ | (_writable ? PROT_WRITE : 0);
+        void *base = ::mmap(nullptr, size, prot, MAP_SHARED, _fd, 0);
+        if (base == MAP_FAILED) throw_errno("mmap");
+        _base = static_cast<std::byte *>(base);
+        _mapped = size;
+    }
+
+    void unmap() noexcept {
+        if (_base) ::munmap(_base, _mapped);
+        _base = nullptr;
+        _mapped = 0;
+    }
+
+    void close() noexcept {
+        unmap();
+        if (_fd >= 0) ::close(_fd);
+        _fd = -1;
+    }
+
+    int _fd = -1;
+    bool _writable = false;
+    table_layout _layout = table_layout::rows;
+    std::byte *_base = nullptr;
+    size_type _mapped = 0;
+    size_type _capacity = 0;
+};
+}  // namespace reflect
+
+#endif
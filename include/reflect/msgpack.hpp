@@ -0,0 +1,463 @@
+/* MIT License
+ *
+ * Copyright (c) 2024 Nichts Hsu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * @file msgpack.hpp
+ * @brief MessagePack encoding of reflected records.
+ */
+
+#ifndef REFLECT_MSGPACK_HPP
+#define REFLECT_MSGPACK_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "lookup.hpp"
+
+namespace reflect {
+/**
+ * @brief MessagePack encoding of reflected records.
+ * @details
+ * Records are encoded as maps from member names to values. Integers use the
+ * smallest format holding the value, strings and `std::string_view` are
+ * `str`, ranges are `array` and nested records are `map`. A `char[N]` member
+ * is a `str` of at most N characters, terminated by `'\0'` if shorter.
+ *
+ * The map header and the key of every member are assembled at compile time;
+ * `write` only copies them and encodes the values. `read` dispatches keys
+ * through `member_lookup`, and `std::string_view` members refer into the
+ * input bytes, so reading does not allocate unless members do.
+ */
+namespace msgpack {
+/**
+ * @brief Internal implementation of `msgpack`.
+ * Header of a `str` of length `Size`.
+ */
+template <std::size_t Size>
+consteval auto str_header() {
+    if constexpr (Size < 32)
+        return conststr::cstr(char(0xA0 | Size));
+    else if constexpr (Size < 0x100)
+        return conststr::cstr<2>(char(0xD9), char(Size));
+    else
+        return conststr::cstr<3>(char(0xDA), char(Size >> 8), char(Size));
+}
+
+/**
+ * @brief Encoded map key of the I-th member of `T`, header followed by name.
+ */
+template <typename T, std::size_t I>
+constexpr auto key_of = str_header<name_of<T, I>.size()>() + name_of<T, I>;
+
+/**
+ * @brief Encoded map header of `T`.
+ */
+template <typename T>
+constexpr auto map_header_of = [] {
+    constexpr std::size_t n = number_of_members<T>;
+    if constexpr (n < 16)
+        return conststr::cstr(char(0x80 | n));
+    else
+        return conststr::cstr<3>(char(0xDE), char(n >> 8), char(n));
+}();
+
+/**
+ * @brief Internal implementation of `msgpack`.
+ * Append the bytes of a compile-time string.
+ */
+template <std::size_t N, typename V>
+void put(std::vector<std::byte> &out, const conststr::cstr<N, char, V> &str) {
+    const auto *bytes = reinterpret_cast<const std::byte *>(str.data());
+    out.insert(out.end(), bytes, bytes + N);
+}
+
+/**
+ * @brief Internal implementation of `msgpack`.
+ * Append a format byte followed by `value` in big-endian order.
+ */
+template <std::unsigned_integral U>
+void put(std::vector<std::byte> &out, std::uint8_t format, U value) {
+    out.push_back(std::byte(format));
+    for (std::size_t i = sizeof(U); i-- > 0;)
+        out.push_back(std::byte(value >> (8 * i)));
+}
+
+/**
+ * @brief Internal implementation of `msgpack`.
+ * Append a `str`, `array` or `map` header.
+ * @param fix first byte of the fix format
+ * @param limit maximum length of the fix format
+ * @param format8 format byte of the 8-bit length, or 0 if there is none
+ */
+inline void put_header(std::vector<std::byte> &out, std::size_t size,
+                       std::uint8_t fix, std::size_t limit,
+                       std::uint8_t format8) {
+    if (size < limit)
+        out.push_back(std::byte(fix | size));
+    else if (format8 != 0 && size < 0x100)
+        put(out, format8, std::uint8_t(size));
+    else if (size < 0x10000)
+        put(out, format8 != 0 ? format8 + 1 : fix == 0x90 ? 0xDC : 0xDE,
+            std::uint16_t(size));
+    else
+        put(out, format8 != 0 ? format8 + 2 : fix == 0x90 ? 0xDD : 0xDF,
+            std::uint32_t(size));
+}
+
+template <reflectable T>
+void write(const T &obj, std::vector<std::byte> &out);
+
+/**
+ * @brief Internal implementation of `msgpack`.
+ * Whether `M` is a fixed-size character buffer.
+ */
+template <typename M>
+constexpr bool is_char_array =
+    std::is_bounded_array_v<M> &&
+    std::is_same_v<std::remove_cv_t<std::remove_extent_t<M>>, char>;
+
+/**
+ * @brief Internal implementation of `msgpack`.
+ * Append one value.
+ */
+template <typename M>
+void put_value(std::vector<std::byte> &out, const M &value) {
+    if constexpr (std::is_same_v<M, bool>) {
+        out.push_back(std::byte(value ? 0xC3 : 0xC2));
+    } else if constexpr (std::is_enum_v<M>) {
+        put_value(out, std::underlying_type_t<M>(value));
+    } else if constexpr (std::is_integral_v<M>) {
+        if (value >= 0) {
+            std::uint64_t u = std::uint64_t(value);
+            if (u < 0x80)
+                out.push_back(std::byte(u));
+            else if (u < 0x100)
+                put(out, 0xCC, std::uint8_t(u));
+            else if (u < 0x10000)
+                put(out, 0xCD, std::uint16_t(u));
+            else if (u < 0x100000000)
+                put(out, 0xCE, std::uint32_t(u));
+            else
+                put(out, 0xCF, u);
+        } else {
+            std::int64_t s = std::int64_t(value);
+            if (s >= -32)
+                out.push_back(std::byte(std::uint8_t(s)));
+            else if (s >= -0x80)
+                put(out, 0xD0, std::uint8_t(s));
+            else if (s >= -0x8000)
+                put(out, 0xD1, std::uint16_t(s));
+            else if (s >= -0x80000000ll)
+                put(out, 0xD2, std::uint32_t(s));
+            else
+                put(out, 0xD3, std::uint64_t(s));
+        }
+    } else if constexpr (std::is_same_v<M, float>) {
+        put(out, 0xCA, std::bit_cast<std::uint32_t>(value));
+    } else if constexpr (std::is_same_v<M, double>) {
+        put(out, 0xCB, std::bit_cast<std::uint64_t>(value));
+    } else if constexpr (is_char_array<M>) {
+        auto end = std::find(std::begin(value), std::end(value), '\0');
+        put_value(out, std::string_view(std::begin(value), end));
+    } else if constexpr (std::is_convertible_v<const M &, std::string_view>) {
+        std::string_view str(value);
+        put_header(out, str.size(), 0xA0, 32, 0xD9);
+        const auto *bytes = reinterpret_cast<const std::byte *>(str.data());
+        out.insert(out.end(), bytes, bytes + str.size());
+    } else if constexpr (reflectable<M>) {
+        write(value, out);
+    } else if constexpr (std::ranges::sized_range<const M>) {
+        put_header(out, std::ranges::size(value), 0x90, 16, 0);
+        for (const auto &element : value) put_value(out, element);
+    } else {
+        static_assert(!sizeof(M), "type is not supported by msgpack");
+    }
+}
+
+/**
+ * @brief Append the MessagePack encoding of `obj` to `out`.
+ * @param obj object of default-constructible aggregate type
+ * @param out output buffer, appending is allocation-free once it has grown
+ */
+template <reflectable T>
+void write(const T &obj, std::vector<std::byte> &out) {
+    put(out, map_header_of<T>);
+    [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+        ((put(out, key_of<T, Is>), put_value(out, member_of<Is>(obj))), ...);
+    }(std::make_index_sequence<number_of_members<T>>{});
+}
+
+/**
+ * @brief Get the MessagePack encoding of `obj`.
+ * @param obj object of default-constructible aggregate type
+ * @return Encoded bytes.
+ */
+template <reflectable T>
+std::vector<std::byte> write(const T &obj) {
+    std::vector<std::byte> out;
+    write(obj, out);
+    return out;
+}
+
+/**
+ * @brief Internal implementation of `msgpack`.
+ * Cursor over the input of `read`.
+ */
+struct reader {
+    const std::byte *pos;
+    const std::byte *end;
+
+    [[noreturn]] static void fail(const char *what) {
+        throw std::runtime_error(std::string("msgpack: ") + what);
+    }
+
+    std::uint8_t peek() const {
+        if (pos == end) fail("unexpected end of input");
+        return std::uint8_t(*pos);
+    }
+
+    std::span<const std::byte> take(std::size_t size) {
+        if (std::size_t(end - pos) < size) fail("unexpected end of input");
+        std::span<const std::byte> bytes(pos, size);
+        pos += size;
+        return bytes;
+    }
+
+    std::uint64_t big_endian(std::size_t size) {
+        std::uint64_t value = 0;
+        for (std::byte b : take(size)) value = (value << 8) | std::uint8_t(b);
+        return value;
+    }
+
+    std::size_t header(std::uint8_t fix_mask, std::uint8_t fix,
+                       std::uint8_t format8, std::uint8_t format16,
+                       const char *what) {
+        std::uint8_t format = std::uint8_t(*take(1).data());
+        if ((format & fix_mask) == fix) return format & ~fix_mask;
+        if (format8 != 0 && format == format8) return big_endian(1);
+        if (format == format16) return big_endian(2);
+        if (format == format16 + 1) return big_endian(4);
+        fail(what);
+    }
+
+    std::string_view str() {
+        std::size_t size = header(0xE0, 0xA0, 0xD9, 0xDA, "expected str");
+        auto bytes = take(size);
+        return {reinterpret_cast<const char *>(bytes.data()), size};
+    }
+
+    std::size_t array() {
+        return header(0xF0, 0x90, 0, 0xDC, "expected array");
+    }
+
+    std::size_t map() { return header(0xF0, 0x80, 0, 0xDE, "expected map"); }
+
+    template <typename I>
+    I integer() {
+        std::uint8_t format = std::uint8_t(*take(1).data());
+        bool negative = false;
+        std::uint64_t raw;
+        if (format < 0x80) {
+            raw = format;
+        } else if (format >= 0xE0) {
+            raw = std::uint64_t(std::int64_t(std::int8_t(format)));
+            negative = true;
+        } else if (format >= 0xCC && format <= 0xCF) {
+            raw = big_endian(std::size_t(1) << (format - 0xCC));
+        } else if (format >= 0xD0 && format <= 0xD3) {
+            std::size_t size = std::size_t(1) << (format - 0xD0);
+            raw = big_endian(size);
+            if (size < 8 && (raw >> (8 * size - 1)))
+                raw |= ~std::uint64_t(0) << (8 * size);
+            negative = std::int64_t(raw) < 0;
+        } else {
+            fail("expected integer");
+        }
+        if (negative) {
+            if constexpr (std::is_signed_v<I>)
+                if (std::int64_t(raw) >= std::numeric_limits<I>::min())
+                    return I(std::int64_t(raw));
+        } else if (raw <= std::uint64_t(std::numeric_limits<I>::max())) {
+            return I(raw);
+        }
+        fail("integer out of range");
+    }
+
+    /**
+     * @brief Skip the header and payload of one value.
+     * @return Number of values nested in it, which still have to be skipped.
+     */
+    std::size_t skip_shallow() {
+        constexpr std::size_t fixed_sizes[] = {4, 8, 1, 2, 4, 8, 1, 2, 4, 8};
+        std::uint8_t format = std::uint8_t(*take(1).data());
+        std::size_t size = 0, count = 0;
+        if ((format & 0xF0) == 0x80)  // fixmap
+            count = 2 * (format & 0x0F);
+        else if ((format & 0xF0) == 0x90)  // fixarray
+            count = format & 0x0F;
+        else if ((format & 0xE0) == 0xA0)  // fixstr
+            size = format & 0x1F;
+        else if (format == 0xC1)
+            fail("invalid format");
+        else if (format >= 0xC4 && format <= 0xC6)  // bin
+            size = big_endian(std::size_t(1) << (format - 0xC4));
+        else if (format >= 0xC7 && format <= 0xC9)  // ext
+            size = big_endian(std::size_t(1) << (format - 0xC7)) + 1;
+        else if (format >= 0xCA && format <= 0xD3)  // float, uint, int
+            size = fixed_sizes[format - 0xCA];
+        else if (format >= 0xD4 && format <= 0xD8)  // fixext
+            size = (std::size_t(1) << (format - 0xD4)) + 1;
+        else if (format >= 0xD9 && format <= 0xDB)  // str
+            size = big_endian(std::size_t(1) << (format - 0xD9));
+        else if (format == 0xDC || format == 0xDD)  // array
+            count = big_endian(format == 0xDC ? 2 : 4);
+        else if (format == 0xDE || format == 0xDF)  // map
+            count = 2 * big_endian(format == 0xDE ? 2 : 4);
+        take(size);
+        return count;
+    }
+
+    void skip() {
+        // Nested values are counted rather than recursed into, so deeply
+        // nested input cannot overflow the stack.
+        for (std::size_t pending = 1; pending > 0; --pending)
+            pending += skip_shallow();
+    }
+};
+
+template <reflectable T>
+void read(reader &in, T &obj);
+
+/**
+ * @brief Internal implementation of `msgpack`.
+ * Read one value into `value`.
+ */
+template <typename M>
+void get_value(reader &in, M &value) {
+    if constexpr (std::is_same_v<M, bool>) {
+        std::uint8_t format = std::uint8_t(*in.take(1).data());
+        if (format != 0xC2 && format != 0xC3) in.fail("expected bool");
+        value = format == 0xC3;
+    } else if constexpr (std::is_enum_v<M>) {
+        value = M(in.integer<std::underlying_type_t<M>>());
+    } else if constexpr (std::is_integral_v<M>) {
+        value = in.integer<M>();
+    } else if constexpr (std::is_floating_point_v<M>) {
+        std::uint8_t format = in.peek();
+        if (format == 0xCA) {
+            in.take(1);
+            value = M(std::bit_cast<float>(std::uint32_t(in.big_endian(4))));
+        } else if (format == 0xCB) {
+            in.take(1);
+            value = M(std::bit_cast<double>(in.big_endian(8)));
+        } else if ((format >= 0xD0 && format <= 0xD3) || format >= 0xE0) {
+            value = M(in.integer<std::int64_t>());
+        } else {
+            value = M(in.integer<std::uint64_t>());
+        }
+    } else if constexpr (is_char_array<M>) {
+        std::string_view str = in.str();
+        if (str.size() > std::extent_v<M>) in.fail("str too long");
+        std::fill(std::begin(value), std::end(value), '\0');
+        std::copy(str.begin(), str.end(), value);
+    } else if constexpr (std::is_constructible_v<M, std::string_view>) {
+        value = M(in.str());
+    } else if constexpr (reflectable<M>) {
+        read(in, value);
+    } else if constexpr (requires { value.push_back(value.front()); }) {
+        std::size_t count = in.array();
+        value.clear();
+        for (std::size_t i = 0; i < count; ++i) {
+            value.emplace_back();
+            get_value(in, value.back());
+        }
+    } else if constexpr (std::ranges::sized_range<M>) {
+        if (in.array() != std::ranges::size(value))
+            in.fail("array size mismatch");
+        for (auto &element : value) get_value(in, element);
+    } else {
+        static_assert(!sizeof(M), "type is not supported by msgpack");
+    }
+}
+
+/**
+ * @brief Internal implementation of `msgpack`.
+ * Jump table from member indices to member readers.
+ */
+template <typename T>
+constexpr auto readers =
+    []<std::size_t... Is>(std::index_sequence<Is...>) {
+        return std::array<void (*)(reader &, T &), sizeof...(Is)>{
+            [](reader &in, T &obj) { get_value(in, member_of<Is>(obj)); }...};
+    }(std::make_index_sequence<number_of_members<T>>{});
+
+/**
+ * @brief Internal implementation of `msgpack`.
+ * Read a map into `obj`, ignoring unknown keys and `nil` values.
+ */
+template <reflectable T>
+void read(reader &in, T &obj) {
+    std::size_t count = in.map();
+    for (std::size_t i = 0; i < count; ++i) {
+        std::size_t index = member_lookup<T>.find(in.str());
+        if (index == member_lookup<T>.npos || in.peek() == 0xC0)
+            in.skip();
+        else
+            readers<T>[index](in, obj);
+    }
+}
+
+/**
+ * @brief Decode a record from its MessagePack encoding.
+ * @details
+ * The input must be a map. Members missing from it are value-initialized,
+ * unknown keys are skipped. Any integer format is accepted as long as the
+ * value fits in the member.
+ * @tparam T default-constructible aggregate type
+ * @param bytes encoded bytes, which `std::string_view` members refer to
+ * @return Decoded record.
+ * @exception std::runtime_error if `bytes` is malformed or does not match `T`.
+ */
+template <reflectable T>
+T read(std::span<const std::byte> bytes) {
+    T obj{};
+    reader in{bytes.data(), bytes.data() + bytes.size()};
+    read(in, obj);
+    return obj;
+}
+}  // namespace msgpack
+}  // namespace reflect
+
+#endif
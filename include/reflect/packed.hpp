@@ -0,0 +1,270 @@
+/* MIT License
+ *
+ * Copyright (c) 2024 Nichts Hsu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * @file packed.hpp
+ * @brief Bit-packed storage of records with narrow members.
+ */
+
+#ifndef REFLECT_PACKED_HPP
+#define REFLECT_PACKED_HPP
+
+#include <array>
+#include <climits>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "../reflect.hpp"
+
+namespace reflect {
+/**
+ * @brief Width in bits of the member `Name` in `packed`.
+ * @tparam Name name of the member
+ * @tparam Width number of bits, from 1 to 64
+ */
+template <conststr::cstr Name, std::size_t Width>
+struct bits {
+    static_assert(Width >= 1 && Width <= 64, "bit width must be in [1, 64]");
+    static constexpr auto name = Name;
+    static constexpr std::size_t width = Width;
+};
+
+/**
+ * @brief This concept is satisfied if `M` can be stored in `packed`.
+ * @tparam M any type
+ */
+template <typename M>
+concept bit_packable =
+    (std::is_integral_v<M> || std::is_enum_v<M>) && sizeof(M) <= 8;
+
+/**
+ * @brief Record of type `T` stored with each member in the fewest bits.
+ * @details
+ * Every member of `T` must be a `bool`, an integer or an enumeration.
+ * Members listed in `Widths` take the given number of bits, at most the width
+ * of their type, other `bool` members take 1 bit and other members their full
+ * width. Members are laid out one after another without padding, and the
+ * whole record is stored in the smallest unsigned integer holding all bits,
+ * or an array of `std::uint64_t` if it needs more than 64 bits. For example:
+ * @code{.cpp}
+ * enum class Level : std::uint8_t { ... };
+ * struct State {
+ *     bool online;
+ *     std::uint8_t flags;
+ *     Level level;
+ *     std::int32_t delta;
+ * };
+ * using packed_state = reflect::packed<State, reflect::bits<"flags", 3>,
+ *                                      reflect::bits<"level", 2>,
+ *                                      reflect::bits<"delta", 10>>;
+ * static_assert(sizeof(packed_state) == 2);
+ * packed_state s(state);
+ * s.set<"flags">(5);
+ * State back = s.load();
+ * @endcode
+ * @note Values are truncated to the width of their member when stored, and
+ * signed members are sign-extended when loaded.
+ * @tparam T default-constructible aggregate type
+ * @tparam Widths list of `bits`
+ */
+template <reflectable T, typename... Widths>
+class packed {
+    template <std::size_t N>
+    static consteval std::size_t width_impl() {
+        using M = type_of<T, N>;
+        static_assert(bit_packable<M>, "member is not bit-packable");
+        constexpr std::size_t full =
+            std::is_same_v<M, bool> ? 1 : sizeof(M) * CHAR_BIT;
+        constexpr std::size_t width = [] {
+            std::size_t result = full;
+            static_cast<void>(
+                ((Widths::name == name_of<T, N> ? (result = Widths::width, true)
+                                                : false) ||
+                 ...));
+            return result;
+        }();
+        static_assert(width <= full, "bit width exceeds the member type");
+        return width;
+    }
+
+    // Every name in `Widths` must be a member of `T`.
+    static_assert(((index_of<T, Widths::name> < number_of_members<T>) && ...));
+
+   public:
+    using value_type = T;
+
+    /**
+     * @brief Number of bits of the N-th member.
+     */
+    template <std::size_t N>
+    static constexpr std::size_t width_of = width_impl<N>();
+
+    /**
+     * @brief Bit offset of the N-th member.
+     */
+    template <std::size_t N>
+    static constexpr std::size_t bit_offset_of =
+        []<std::size_t... Is>(std::index_sequence<Is...>) {
+            return (std::size_t(0) + ... + width_of<Is>);
+        }(std::make_index_sequence<N>{});
+
+    /**
+     * @brief Total number of bits of all members.
+     */
+    static constexpr std::size_t total_bits =
+        bit_offset_of<number_of_members<T>>;
+
+    /**
+     * @brief Unsigned integer type of the storage.
+     */
+    using word_type = std::conditional_t<
+        total_bits <= 8, std::uint8_t,
+        std::conditional_t<
+            total_bits <= 16, std::uint16_t,
+            std::conditional_t<total_bits <= 32, std::uint32_t,
+                               std::uint64_t>>>;
+
+    /**
+     * @brief Construct with all members zero.
+     */
+    constexpr packed() noexcept = default;
+
+    /**
+     * @brief Pack `obj`.
+     */
+    constexpr explicit packed(const T &obj) noexcept { store(obj); }
+
+    /**
+     * @brief Get the N-th member.
+     * @tparam N index of member
+     */
+    template <std::size_t N>
+    constexpr type_of<T, N> get() const noexcept {
+        using M = type_of<T, N>;
+        std::uint64_t raw = read(bit_offset_of<N>, width_of<N>);
+        if constexpr (std::is_same_v<M, bool>) {
+            return raw != 0;
+        } else {
+            using U = std::conditional_t<std::is_enum_v<M>,
+                                         std::underlying_type<M>,
+                                         std::type_identity<M>>::type;
+            if constexpr (std::is_signed_v<U> && width_of<N> < 64)
+                if (raw >> (width_of<N> - 1)) raw |= ~mask(width_of<N>);
+            return M(U(raw));
+        }
+    }
+
+    /**
+     * @brief Get the member via its name.
+     * @tparam Name name of member
+     */
+    template <conststr::cstr Name>
+    constexpr type_of_member<T, Name> get() const noexcept
+        requires std::same_as<typename decltype(Name)::value_type, char>
+    {
+        return get<index_of<T, Name>>();
+    }
+
+    /**
+     * @brief Set the N-th member, truncated to its width.
+     * @tparam N index of member
+     * @param value new value
+     */
+    template <std::size_t N>
+    constexpr void set(const type_of<T, N> &value) noexcept {
+        write(bit_offset_of<N>, width_of<N>, std::uint64_t(value));
+    }
+
+    /**
+     * @brief Set the member via its name, truncated to its width.
+     * @tparam Name name of member
+     * @param value new value
+     */
+    template <conststr::cstr Name>
+    constexpr void set(const type_of_member<T, Name> &value) noexcept
+        requires std::same_as<typename decltype(Name)::value_type, char>
+    {
+        set<index_of<T, Name>>(value);
+    }
+
+    /**
+     * @brief Unpack into a `T`.
+     */
+    constexpr T load() const noexcept {
+        T obj{};
+        [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            ((member_of<Is>(obj) = get<Is>()), ...);
+        }(std::make_index_sequence<number_of_members<T>>{});
+        return obj;
+    }
+
+    /**
+     * @brief Pack all members of `obj`.
+     */
+    constexpr void store(const T &obj) noexcept {
+        [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            (set<Is>(member_of<Is>(obj)), ...);
+        }(std::make_index_sequence<number_of_members<T>>{});
+    }
+
+    constexpr bool operator==(const packed &) const noexcept = default;
+
+   private:
+    static constexpr std::size_t word_bits = sizeof(word_type) * CHAR_BIT;
+    static constexpr std::size_t words =
+        total_bits == 0 ? 1 : (total_bits + word_bits - 1) / word_bits;
+
+    static constexpr std::uint64_t mask(std::size_t width) noexcept {
+        return width == 64 ? ~std::uint64_t(0)
+                           : (std::uint64_t(1) << width) - 1;
+    }
+
+    constexpr std::uint64_t read(std::size_t offset,
+                                 std::size_t width) const noexcept {
+        std::size_t index = offset / word_bits, shift = offset % word_bits;
+        std::uint64_t raw = std::uint64_t(_words[index]) >> shift;
+        if (shift + width > word_bits)
+            raw |= std::uint64_t(_words[index + 1]) << (word_bits - shift);
+        return raw & mask(width);
+    }
+
+    constexpr void write(std::size_t offset, std::size_t width,
+                         std::uint64_t value) noexcept {
+        std::size_t index = offset / word_bits, shift = offset % word_bits;
+        value &= mask(width);
+        _words[index] = word_type((_words[index] & ~(mask(width) << shift)) |
+                                  (value << shift));
+        if (shift + width > word_bits) {
+            std::size_t rest = word_bits - shift;
+            _words[index + 1] =
+                word_type((_words[index + 1] & ~(mask(width) >> rest)) |
+                          (value >> rest));
+        }
+    }
+
+    std::array<word_type, words> _words{};
+};
+}  // namespace reflect
+
+#endif
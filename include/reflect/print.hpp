@@ -0,0 +1,243 @@
+/* MIT License
+ *
+ * Copyright (c) 2024 Nichts Hsu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * @file print.hpp
+ * @brief Print reflected records without `std::ostream`.
+ * @details Define `CONSTSTR_NO_IOSTREAM` before including this header to keep
+ * `<iostream>` out of the translation unit.
+ */
+
+#ifndef REFLECT_PRINT_HPP
+#define REFLECT_PRINT_HPP
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstdio>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include "../reflect.hpp"
+
+namespace reflect {
+/**
+ * @brief Internal implementation of `print`.
+ * Text written before the I-th member of `T`, e.g. `"{id: "` or `", name: "`.
+ */
+template <typename T, std::size_t I>
+constexpr auto print_prefix_of = [] {
+    if constexpr (I == 0)
+        return conststr::flatten("{", name_of<T, I>, ": ");
+    else
+        return conststr::flatten(", ", name_of<T, I>, ": ");
+}();
+
+/**
+ * @brief Internal implementation of `print`.
+ * Sink writing to an output iterator.
+ */
+template <typename OutputIt>
+struct iterator_sink {
+    OutputIt out;
+
+    void put(std::string_view str) {
+        out = std::copy(str.begin(), str.end(), out);
+    }
+};
+
+/**
+ * @brief Internal implementation of `print`.
+ * Sink writing to a `FILE *` through a local buffer, flushed with `fwrite`.
+ */
+struct file_sink {
+    std::FILE *file;
+    std::size_t size = 0;
+    char buffer[4096]{};
+
+    void put(std::string_view str) {
+        if (size + str.size() > sizeof(buffer)) {
+            flush();
+            if (str.size() > sizeof(buffer)) {
+                write(str.data(), str.size());
+                return;
+            }
+        }
+        std::char_traits<char>::copy(buffer + size, str.data(), str.size());
+        size += str.size();
+    }
+
+    void flush() {
+        // Reset first, so that the buffer is not written again after a throw.
+        std::size_t count = std::exchange(size, 0);
+        if (count != 0) write(buffer, count);
+    }
+
+    void write(const char *data, std::size_t count) {
+        errno = 0;
+        if (std::fwrite(data, 1, count, file) != count)
+            throw std::system_error(errno != 0 ? errno : EIO,
+                                    std::generic_category(), "print: fwrite");
+    }
+};
+
+/**
+ * @brief Internal implementation of `print`.
+ * Sink writing to a fixed buffer, counting what does not fit.
+ */
+struct buffer_sink {
+    std::span<char> buffer;
+    std::size_t size = 0;
+
+    void put(std::string_view str) {
+        if (size < buffer.size())
+            std::char_traits<char>::copy(
+                buffer.data() + size, str.data(),
+                std::min(str.size(), buffer.size() - size));
+        size += str.size();
+    }
+};
+
+template <typename Sink, reflectable T>
+void print_to(Sink &sink, const T &obj);
+
+/**
+ * @brief Internal implementation of `print`.
+ * Print one value.
+ */
+template <typename Sink, typename M>
+void print_value(Sink &sink, const M &value) {
+    if constexpr (std::is_same_v<M, bool>) {
+        sink.put(value ? "true" : "false");
+    } else if constexpr (std::is_same_v<M, char>) {
+        char quoted[] = {'\'', value, '\''};
+        sink.put({quoted, 3});
+    } else if constexpr (std::is_enum_v<M>) {
+        print_value(sink, std::underlying_type_t<M>(value));
+    } else if constexpr (std::is_arithmetic_v<M>) {
+        char digits[32];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        sink.put({digits, std::size_t(result.ptr - digits)});
+    } else if constexpr (
+        std::is_bounded_array_v<M> &&
+        std::is_same_v<std::remove_cv_t<std::remove_extent_t<M>>, char>) {
+        // Stop at the first null, but never read past the array.
+        sink.put("\"");
+        sink.put(std::string_view(
+            value, std::find(std::begin(value), std::end(value), '\0')));
+        sink.put("\"");
+    } else if constexpr (std::is_convertible_v<const M &, std::string_view>) {
+        sink.put("\"");
+        sink.put(std::string_view(value));
+        sink.put("\"");
+    } else if constexpr (reflectable<M>) {
+        print_to(sink, value);
+    } else if constexpr (std::ranges::input_range<const M>) {
+        sink.put("[");
+        bool first = true;
+        for (const auto &element : value) {
+            if (!first) sink.put(", ");
+            first = false;
+            print_value(sink, element);
+        }
+        sink.put("]");
+    } else {
+        static_assert(!sizeof(M), "type is not supported by print");
+    }
+}
+
+/**
+ * @brief Internal implementation of `print`.
+ * Print a record to any sink.
+ */
+template <typename Sink, reflectable T>
+void print_to(Sink &sink, const T &obj) {
+    if constexpr (number_of_members<T> == 0) {
+        sink.put("{}");
+    } else {
+        [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            ((sink.put(print_prefix_of<T, Is>),
+              print_value(sink, member_of<Is>(obj))),
+             ...);
+        }(std::make_index_sequence<number_of_members<T>>{});
+        sink.put("}");
+    }
+}
+
+/**
+ * @brief Print `obj` as `{name: value, ...}` to an output iterator.
+ * @details
+ * Member names and separators are written from fragments assembled at
+ * compile time, numbers are formatted by `std::to_chars`. Strings are quoted,
+ * `char` arrays up to their first null or their full length,
+ * ranges are printed as `[...]` and nested records recursively.
+ * The iterator can be that of `std::format_to`, for example in a
+ * `std::formatter` of `T`.
+ * @param obj object of default-constructible aggregate type
+ * @param out output iterator of `char`
+ * @return Iterator past the last character written.
+ */
+template <reflectable T, std::output_iterator<char> OutputIt>
+OutputIt print(const T &obj, OutputIt out) {
+    iterator_sink<OutputIt> sink{out};
+    print_to(sink, obj);
+    return sink.out;
+}
+
+/**
+ * @brief Print `obj` as `{name: value, ...}` to a `FILE *`.
+ * @details Output is collected in a local buffer and written by `fwrite` in
+ * batches of up to 4 KiB.
+ * @param obj object of default-constructible aggregate type
+ * @param file file opened for writing
+ * @exception std::system_error if `fwrite` writes fewer bytes than requested.
+ */
+template <reflectable T>
+void print(const T &obj, std::FILE *file) {
+    file_sink sink{file};
+    print_to(sink, obj);
+    sink.flush();
+}
+
+/**
+ * @brief Print `obj` as `{name: value, ...}` to a fixed buffer.
+ * @details Like `snprintf`, output not fitting into `buffer` is dropped, and
+ * no null terminator is written.
+ * @param obj object of default-constructible aggregate type
+ * @param buffer destination buffer
+ * @return Number of characters of the whole output, which is greater than
+ * `buffer.size()` if it has been truncated.
+ */
+template <reflectable T>
+std::size_t print(const T &obj, std::span<char> buffer) {
+    buffer_sink sink{buffer};
+    print_to(sink, obj);
+    return sink.size;
+}
+}  // namespace reflect
+
+#endif
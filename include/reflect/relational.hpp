@@ -0,0 +1,577 @@
+/* MIT License
+ *
+ * Copyright (c) 2024 Nichts Hsu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * @file relational.hpp
+ * @brief Group-by and hash-join over ranges of reflected records.
+ */
+
+#ifndef REFLECT_RELATIONAL_HPP
+#define REFLECT_RELATIONAL_HPP
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <ranges>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+#include "aggregate.hpp"
+
+namespace reflect {
+/**
+ * @brief Named field of a `record`.
+ * @tparam Name name of the field
+ * @tparam T type of the field
+ */
+template <conststr::cstr Name, typename T>
+struct field {
+    static constexpr auto name = Name;
+    using type = T;
+};
+
+/**
+ * @brief Record with named fields, generated by `group_by` and `hash_join`.
+ * @details
+ * Fields can be accessed by index or by name:
+ * @code{.cpp}
+ * reflect::record<reflect::field<"id", int>, reflect::field<"sum_qty", long>> r;
+ * r.get<"id">() = 1;
+ * long qty = r.get<1>();
+ * @endcode
+ * @tparam Fields list of `field`
+ */
+template <typename... Fields>
+struct record {
+    /**
+     * @brief Number of fields.
+     */
+    static constexpr std::size_t size = sizeof...(Fields);
+
+    /**
+     * @brief Name of the I-th field.
+     * @tparam I index of field
+     */
+    template <std::size_t I>
+    static constexpr auto name_of =
+        std::tuple_element_t<I, std::tuple<Fields...>>::name;
+
+    /**
+     * @brief Index of the field by its name.
+     * @tparam Name name of field
+     */
+    template <conststr::cstr Name>
+    static constexpr std::size_t index_of = [] {
+        std::size_t index = 0;
+        bool found = ((Fields::name == Name ? true : (++index, false)) || ...);
+        return found ? index : size;
+    }();
+
+    /**
+     * @brief Values of all fields.
+     */
+    std::tuple<typename Fields::type...> values;
+
+    /**
+     * @brief Get the reference to the I-th field.
+     * @tparam I index of field
+     */
+    template <std::size_t I>
+    constexpr auto &get() noexcept {
+        return std::get<I>(values);
+    }
+
+    /**
+     * @brief Get the reference to the I-th field.
+     * @tparam I index of field
+     */
+    template <std::size_t I>
+    constexpr const auto &get() const noexcept {
+        return std::get<I>(values);
+    }
+
+    /**
+     * @brief Get the reference to the field by its name.
+     * @tparam Name name of field
+     */
+    template <conststr::cstr Name>
+    constexpr auto &get() noexcept
+        requires std::same_as<typename decltype(Name)::value_type, char>
+    {
+        static_assert(index_of<Name> < size, "no such field");
+        return std::get<index_of<Name>>(values);
+    }
+
+    /**
+     * @brief Get the reference to the field by its name.
+     * @tparam Name name of field
+     */
+    template <conststr::cstr Name>
+    constexpr const auto &get() const noexcept
+        requires std::same_as<typename decltype(Name)::value_type, char>
+    {
+        static_assert(index_of<Name> < size, "no such field");
+        return std::get<index_of<Name>>(values);
+    }
+};
+
+/**
+ * @brief Aggregation of `group_by`, sum of the member `Name`.
+ * @details The field in the result is named `"sum_" + Name`.
+ * @see sum_of
+ */
+template <conststr::cstr Name>
+struct sum_aggregator {
+    static constexpr auto name = conststr::cstr("sum_") + Name;
+    template <typename T>
+    using value_type = sum_t<type_of_member<T, Name>>;
+
+    template <typename T>
+    static value_type<T> first(const T &row) {
+        return value_type<T>(member_of<Name>(row));
+    }
+    template <typename T>
+    static void update(value_type<T> &acc, const T &row) {
+        acc += value_type<T>(member_of<Name>(row));
+    }
+};
+
+/**
+ * @brief Aggregation of `group_by`, minimum of the member `Name`.
+ * @details The field in the result is named `"min_" + Name`.
+ * @see min_of
+ */
+template <conststr::cstr Name>
+struct min_aggregator {
+    static constexpr auto name = conststr::cstr("min_") + Name;
+    template <typename T>
+    using value_type = type_of_member<T, Name>;
+
+    template <typename T>
+    static value_type<T> first(const T &row) {
+        return member_of<Name>(row);
+    }
+    template <typename T>
+    static void update(value_type<T> &acc, const T &row) {
+        if (member_of<Name>(row) < acc) acc = member_of<Name>(row);
+    }
+};
+
+/**
+ * @brief Aggregation of `group_by`, maximum of the member `Name`.
+ * @details The field in the result is named `"max_" + Name`.
+ * @see max_of
+ */
+template <conststr::cstr Name>
+struct max_aggregator {
+    static constexpr auto name = conststr::cstr("max_") + Name;
+    template <typename T>
+    using value_type = type_of_member<T, Name>;
+
+    template <typename T>
+    static value_type<T> first(const T &row) {
+        return member_of<Name>(row);
+    }
+    template <typename T>
+    static void update(value_type<T> &acc, const T &row) {
+        if (acc < member_of<Name>(row)) acc = member_of<Name>(row);
+    }
+};
+
+/**
+ * @brief Aggregation of `group_by`, number of records.
+ * @details The field in the result is named `"count"`.
+ * @see count_of
+ */
+struct count_aggregator {
+    static constexpr auto name = conststr::cstr("count");
+    template <typename T>
+    using value_type = std::size_t;
+
+    template <typename T>
+    static std::size_t first(const T &) {
+        return 1;
+    }
+    template <typename T>
+    static void update(std::size_t &acc, const T &) {
+        ++acc;
+    }
+};
+
+/**
+ * @brief Sum of the member `Name` in each group.
+ */
+template <conststr::cstr Name>
+constexpr sum_aggregator<Name> sum_of{};
+
+/**
+ * @brief Minimum of the member `Name` in each group.
+ */
+template <conststr::cstr Name>
+constexpr min_aggregator<Name> min_of{};
+
+/**
+ * @brief Maximum of the member `Name` in each group.
+ */
+template <conststr::cstr Name>
+constexpr max_aggregator<Name> max_of{};
+
+/**
+ * @brief Number of records in each group.
+ */
+constexpr count_aggregator count_of{};
+
+/**
+ * @brief Hint the CPU to fetch the cache line containing `ptr`.
+ */
+inline void prefetch(const void *ptr) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(ptr);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_prefetch(static_cast<const char *>(ptr), _MM_HINT_T0);
+#endif
+}
+
+/**
+ * @brief Hash a key of `group_by` or `hash_join`.
+ * @details
+ * Integers and enumerations are mixed directly, other types go through
+ * `std::hash` first. The result is well distributed in its low bits.
+ */
+template <typename K>
+std::uint64_t hash_key(const K &key) noexcept {
+    std::uint64_t x;
+    if constexpr (std::is_integral_v<K> || std::is_enum_v<K>)
+        x = static_cast<std::uint64_t>(key);
+    else
+        x = std::hash<K>{}(key);
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ull;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBull;
+    x ^= x >> 31;
+    return x;
+}
+
+/**
+ * @brief Open-addressing hash index from keys to dense entry positions.
+ * @details
+ * The index only stores positions; keys live in the caller's dense array and
+ * are compared through a callback. Linear probing over a power-of-two table
+ * which is kept at most half full.
+ */
+class flat_index {
+   public:
+    static constexpr std::size_t npos = std::size_t(-1);
+
+    /**
+     * @brief Construct an index sized for `expected` entries.
+     */
+    explicit flat_index(std::size_t expected = 0) { rehash(expected * 2); }
+
+    /**
+     * @brief Prefetch the first slot probed for `hash`.
+     */
+    void prefetch(std::uint64_t hash) const noexcept {
+        reflect::prefetch(&_slots[hash & _mask]);
+    }
+
+    /**
+     * @brief Find the entry whose key satisfies `eq`.
+     * @param hash hash of the key
+     * @param eq returns `true` if the entry at the given position has the key
+     * @return Position of the entry, or `npos` if not found.
+     */
+    template <typename Eq>
+    std::size_t find(std::uint64_t hash, Eq eq) const {
+        for (std::size_t slot = hash & _mask;; slot = (slot + 1) & _mask) {
+            std::uint32_t entry = _slots[slot];
+            if (entry == 0) return npos;
+            if (_hashes[entry - 1] == hash && eq(entry - 1)) return entry - 1;
+        }
+    }
+
+    /**
+     * @brief Insert an entry which must not be present yet.
+     * @param hash hash of the key
+     * @return Position of the new entry, equal to the number of entries before.
+     */
+    std::size_t insert(std::uint64_t hash) {
+        if ((_hashes.size() + 1) * 2 > _slots.size())
+            rehash(_slots.size() * 2);
+        _hashes.push_back(hash);
+        place(hash, std::uint32_t(_hashes.size()));
+        return _hashes.size() - 1;
+    }
+
+    /**
+     * @brief Get the number of entries.
+     */
+    std::size_t size() const noexcept { return _hashes.size(); }
+
+   private:
+    void rehash(std::size_t capacity) {
+        std::size_t size = 16;
+        while (size < capacity) size *= 2;
+        _slots.assign(size, 0);
+        _mask = size - 1;
+        for (std::size_t i = 0; i < _hashes.size(); ++i)
+            place(_hashes[i], std::uint32_t(i + 1));
+    }
+
+    void place(std::uint64_t hash, std::uint32_t entry) noexcept {
+        std::size_t slot = hash & _mask;
+        while (_slots[slot] != 0) slot = (slot + 1) & _mask;
+        _slots[slot] = entry;
+    }
+
+    std::vector<std::uint32_t> _slots;
+    std::vector<std::uint64_t> _hashes;
+    std::size_t _mask = 0;
+};
+
+/**
+ * @brief Number of rows hashed and prefetched ahead of probing.
+ */
+constexpr std::size_t batch_size = 16;
+
+/**
+ * @brief Group a range of records by the member `Key` and aggregate each group.
+ * @details
+ * For example:
+ * @code{.cpp}
+ * auto groups = reflect::group_by<"symbol">(trades, reflect::sum_of<"qty">,
+ *                                            reflect::count_of);
+ * for (const auto &g : groups)
+ *     std::cout << g.get<"symbol">() << g.get<"sum_qty">() << g.get<"count">();
+ * @endcode
+ * Rows are hashed in batches, and the slots they probe are prefetched before
+ * the batch is inserted into the hash index.
+ * @tparam Key name of the member to group by
+ * @param range input range of default-constructible aggregate type
+ * @param aggregators any of `sum_of`, `min_of`, `max_of` and `count_of`
+ * @return `std::vector` of `record` with the field `Key` followed by one field
+ * per aggregation, in the order of first appearance of each key.
+ */
+template <conststr::cstr Key, std::ranges::random_access_range R,
+          typename... Aggregators>
+auto group_by(R &&range, Aggregators...)
+    requires std::same_as<typename decltype(Key)::value_type, char>
+{
+    using T = std::ranges::range_value_t<R>;
+    using K = type_of_member<T, Key>;
+    using result_t =
+        record<field<Key, K>,
+               field<Aggregators::name,
+                     typename Aggregators::template value_type<T>>...>;
+
+    std::vector<result_t> results;
+    flat_index index;
+    const std::size_t count = std::ranges::size(range);
+    auto rows = std::ranges::begin(range);
+    std::array<std::uint64_t, batch_size> hashes;
+    for (std::size_t base = 0; base < count; base += batch_size) {
+        std::size_t n = std::min(batch_size, count - base);
+        for (std::size_t i = 0; i < n; ++i) {
+            hashes[i] = hash_key(member_of<Key>(rows[base + i]));
+            index.prefetch(hashes[i]);
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            const T &row = rows[base + i];
+            const K &key = member_of<Key>(row);
+            std::size_t pos = index.find(hashes[i], [&](std::size_t p) {
+                return results[p].template get<0>() == key;
+            });
+            if (pos == flat_index::npos) {
+                index.insert(hashes[i]);
+                results.push_back(
+                    {{key, Aggregators::template first<T>(row)...}});
+            } else {
+                [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+                    (Aggregators::template update<T>(
+                         results[pos].template get<Is + 1>(), row),
+                     ...);
+                }(std::index_sequence_for<Aggregators...>{});
+            }
+        }
+    }
+    return results;
+}
+
+/**
+ * @brief Internal implementation of `hash_join`.
+ * Name of the J-th member of `R` in the joined record, prefixed with
+ * `"right_"` if `L` has a member of the same name.
+ */
+template <typename L, typename R, std::size_t J>
+consteval auto joined_name() {
+    constexpr bool clash = []<std::size_t... Is>(std::index_sequence<Is...>) {
+        return ((name_of<L, Is> == name_of<R, J>) || ...);
+    }(std::make_index_sequence<number_of_members<L>>{});
+    if constexpr (clash)
+        return conststr::cstr("right_") + name_of<R, J>;
+    else
+        return name_of<R, J>;
+}
+
+/**
+ * @brief Internal implementation of `hash_join`.
+ * Type of the joined record of `L` and `R`.
+ */
+template <typename L, typename R, std::size_t... Is, std::size_t... Js>
+auto joined_record(std::index_sequence<Is...>, std::index_sequence<Js...>)
+    -> record<field<name_of<L, Is>, type_of<L, Is>>...,
+              field<joined_name<L, R, Js>(), type_of<R, Js>>...>;
+
+/**
+ * @brief Internal implementation of `hash_join`.
+ * Type in which keys of type `LK` and `RK` are hashed and compared.
+ * @details
+ * Keys that compare equal must hash equal, so both sides are converted to a
+ * common type first, e.g. `int` and `unsigned` to `unsigned`. String-like
+ * keys are compared as `std::string_view`.
+ */
+template <typename LK, typename RK>
+auto join_key_type() {
+    if constexpr (std::is_convertible_v<const LK &, std::string_view> &&
+                  std::is_convertible_v<const RK &, std::string_view>) {
+        return std::type_identity<std::string_view>{};
+    } else {
+        static_assert(requires { typename std::common_type_t<LK, RK>; },
+                      "hash_join: key types have no common type");
+        return std::type_identity<std::common_type_t<LK, RK>>{};
+    }
+}
+
+/**
+ * @brief Internal implementation of `hash_join`.
+ * View the key member `key` as `K`, without a copy if it already is a `K`.
+ */
+template <typename K, typename M>
+decltype(auto) join_key(const M &key) {
+    if constexpr (std::is_same_v<K, M>)
+        return (key);
+    else
+        return K(key);
+}
+
+/**
+ * @brief Inner equi-join of two ranges of records on `LeftKey == RightKey`.
+ * @details
+ * For example, `reflect::hash_join<"id", "user_id">(users, orders)`.
+ * The right range is indexed by an open-addressing hash table, then the left
+ * range probes it in batches with prefetching.
+ * @tparam LeftKey name of the key member in the left records
+ * @tparam RightKey name of the key member in the right records
+ * @param left left range of default-constructible aggregate type
+ * @param right right range of default-constructible aggregate type
+ * @return `std::vector` of `record` with all members of the left record,
+ * followed by all members of the right record. Right members whose name
+ * already exists on the left are prefixed with `"right_"`. Rows are ordered
+ * by the left range, then by the right range.
+ */
+template <conststr::cstr LeftKey, conststr::cstr RightKey,
+          std::ranges::random_access_range LR,
+          std::ranges::random_access_range RR>
+auto hash_join(LR &&left, RR &&right)
+    requires std::same_as<typename decltype(LeftKey)::value_type, char> &&
+             std::same_as<typename decltype(RightKey)::value_type, char>
+{
+    using L = std::ranges::range_value_t<LR>;
+    using R = std::ranges::range_value_t<RR>;
+    constexpr std::size_t NL = number_of_members<L>;
+    constexpr std::size_t NR = number_of_members<R>;
+    using result_t = decltype(joined_record<L, R>(
+        std::make_index_sequence<NL>{}, std::make_index_sequence<NR>{}));
+
+    using key_type = typename decltype(join_key_type<
+        type_of_member<L, LeftKey>, type_of_member<R, RightKey>>())::type;
+    auto left_key = [](const L &l) -> decltype(auto) {
+        return join_key<key_type>(member_of<LeftKey>(l));
+    };
+    auto right_key = [](const R &r) -> decltype(auto) {
+        return join_key<key_type>(member_of<RightKey>(r));
+    };
+
+    // Build: group right rows by key, rows of a group are chained by `next`.
+    const std::size_t right_count = std::ranges::size(right);
+    auto right_rows = std::ranges::begin(right);
+    constexpr std::size_t none = std::size_t(-1);
+    flat_index index(right_count);
+    std::vector<std::pair<std::size_t, std::size_t>> groups;
+    std::vector<std::size_t> next(right_count, none);
+    for (std::size_t j = 0; j < right_count; ++j) {
+        const auto &key = right_key(right_rows[j]);
+        std::uint64_t hash = hash_key(key);
+        std::size_t pos = index.find(hash, [&](std::size_t p) {
+            return right_key(right_rows[groups[p].first]) == key;
+        });
+        if (pos == flat_index::npos) {
+            index.insert(hash);
+            groups.emplace_back(j, j);
+        } else {
+            next[groups[pos].second] = j;
+            groups[pos].second = j;
+        }
+    }
+
+    // Probe with left rows in batches.
+    std::vector<result_t> results;
+    const std::size_t left_count = std::ranges::size(left);
+    auto left_rows = std::ranges::begin(left);
+    std::array<std::uint64_t, batch_size> hashes;
+    for (std::size_t base = 0; base < left_count; base += batch_size) {
+        std::size_t n = std::min(batch_size, left_count - base);
+        for (std::size_t i = 0; i < n; ++i) {
+            hashes[i] = hash_key(left_key(left_rows[base + i]));
+            index.prefetch(hashes[i]);
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            const L &l = left_rows[base + i];
+            const auto &key = left_key(l);
+            std::size_t pos = index.find(hashes[i], [&](std::size_t p) {
+                return right_key(right_rows[groups[p].first]) == key;
+            });
+            if (pos == flat_index::npos) continue;
+            for (std::size_t j = groups[pos].first; j != none; j = next[j]) {
+                const R &r = right_rows[j];
+                [&]<std::size_t... Is, std::size_t... Js>(
+                    std::index_sequence<Is...>, std::index_sequence<Js...>) {
+                    results.push_back(
+                        {{member_of<Is>(l)..., member_of<Js>(r)...}});
+                }(std::make_index_sequence<NL>{},
+                  std::make_index_sequence<NR>{});
+            }
+        }
+    }
+    return results;
+}
+}  // namespace reflect
+
+#endif
@@ -0,0 +1,313 @@
+/* MIT License
+ *
+ * Copyright (c) 2024 Nichts Hsu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * @file sort.hpp
+ * @brief Sort ranges of reflected records by member names.
+ */
+
+#ifndef REFLECT_SORT_HPP
+#define REFLECT_SORT_HPP
+
+#include <array>
+#include <cstring>
+#include <ranges>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "../reflect.hpp"
+
+namespace reflect {
+/**
+ * @brief Internal implementation of `sort_key`.
+ * Normalized key encoding of one member type.
+ * @details
+ * `encode` writes `size` bytes which compare with `memcmp` in the same order
+ * as the values compare with `<`. `exact` is `false` when the bytes are only
+ * a prefix of the order, such as the first bytes of a string.
+ * @tparam M type of the member
+ */
+template <typename M>
+struct key_codec;
+
+/**
+ * @brief Write the `Size` low bytes of `value` in big-endian order.
+ */
+template <std::size_t Size>
+constexpr void store_big_endian(unsigned char *out, std::uint64_t value) {
+    for (std::size_t i = 0; i < Size; ++i)
+        out[i] = static_cast<unsigned char>(value >> ((Size - 1 - i) * 8));
+}
+
+/**
+ * @brief Key encoding of integers and enumerations: big-endian bytes, with
+ * the sign bit flipped for signed types.
+ * @note `char` is ordered as unsigned, the same as strings.
+ */
+template <typename M>
+    requires std::is_integral_v<M> || std::is_enum_v<M>
+struct key_codec<M> {
+    static constexpr std::size_t size = sizeof(M);
+    static constexpr bool exact = true;
+
+    static void encode(const M &value, unsigned char *out) noexcept {
+        using I = typename std::conditional_t<std::is_enum_v<M>,
+                                              std::underlying_type<M>,
+                                              std::type_identity<M>>::type;
+        using U = std::make_unsigned_t<
+            std::conditional_t<std::is_same_v<I, bool>, unsigned char, I>>;
+        U bits = static_cast<U>(value);
+        if constexpr (std::is_signed_v<I> && !std::is_same_v<I, char>)
+            bits ^= U(U(1) << (sizeof(U) * 8 - 1));
+        store_big_endian<size>(out, bits);
+    }
+};
+
+/**
+ * @brief Key encoding of IEEE-754 floating-point numbers: the sign bit is
+ * flipped for positive numbers and all bits are inverted for negative numbers.
+ * @note `-0.0` is encoded as `+0.0`, since they compare equal.
+ */
+template <typename M>
+    requires std::is_floating_point_v<M> && (sizeof(M) <= 8)
+struct key_codec<M> {
+    static constexpr std::size_t size = sizeof(M);
+    static constexpr bool exact = true;
+
+    static void encode(const M &value, unsigned char *out) noexcept {
+        using U = std::conditional_t<sizeof(M) == 4, std::uint32_t,
+                                     std::uint64_t>;
+        const M canonical = value == M(0) ? M(0) : value;
+        U bits;
+        std::memcpy(&bits, &canonical, sizeof(bits));
+        constexpr U sign = U(1) << (sizeof(U) * 8 - 1);
+        bits = bits & sign ? ~bits : bits | sign;
+        store_big_endian<size>(out, bits);
+    }
+};
+
+/**
+ * @brief Key encoding of character arrays: the characters as unsigned bytes.
+ */
+template <typename C, std::size_t N>
+    requires(sizeof(C) == 1 && conststr::charutils::char_like<C>)
+struct key_codec<C[N]> {
+    static constexpr std::size_t size = N;
+    static constexpr bool exact = true;
+
+    static void encode(const C (&value)[N], unsigned char *out) noexcept {
+        std::memcpy(out, value, N);
+    }
+};
+
+/**
+ * @brief Key encoding of strings: the first 8 characters, padded with zeros.
+ */
+template <typename M>
+    requires std::convertible_to<const M &, std::string_view>
+struct key_codec<M> {
+    static constexpr std::size_t size = 8;
+    static constexpr bool exact = false;
+
+    static void encode(const M &value, unsigned char *out) noexcept {
+        std::string_view str = value;
+        std::size_t len = std::min(str.size(), size);
+        std::memcpy(out, str.data(), len);
+        std::memset(out + len, 0, size - len);
+    }
+};
+
+/**
+ * @brief Compare two members with `<`, arrays are compared lexicographically
+ * and strings as `std::string_view`, the same as their key encoding.
+ */
+template <typename M>
+bool member_less(const M &lhs, const M &rhs) {
+    if constexpr (std::is_array_v<M>)
+        return std::lexicographical_compare(
+            std::begin(lhs), std::end(lhs), std::begin(rhs), std::end(rhs),
+            [](const auto &a, const auto &b) { return member_less(a, b); });
+    else if constexpr (std::is_convertible_v<const M &, std::string_view>)
+        return std::string_view(lhs) < std::string_view(rhs);
+    else if constexpr (std::is_same_v<M, char>)
+        return static_cast<unsigned char>(lhs) <
+               static_cast<unsigned char>(rhs);
+    else
+        return lhs < rhs;
+}
+
+/**
+ * @brief Normalized sort key of type `T` built from the members `Names...`.
+ * @details
+ * The key is the concatenation of the encodings of the named members, so two
+ * keys compare with `memcmp` in the same order as the records compare member
+ * by member. Supported members are integers, enumerations, floating-point
+ * numbers, character arrays and strings. A string only contributes a prefix,
+ * so the members after it are left out of the key.
+ * @tparam T any default-constructible aggregate type
+ * @tparam Names names of the members, the most significant first
+ */
+template <typename T, conststr::cstr... Names>
+struct sort_key {
+   private:
+    static constexpr std::size_t count = sizeof...(Names);
+    static constexpr std::array<std::size_t, count> sizes = {
+        key_codec<type_of_member<T, Names>>::size...};
+    static constexpr std::array<bool, count> exacts = {
+        key_codec<type_of_member<T, Names>>::exact...};
+
+    /**
+     * @brief Number of members encoded into the key.
+     */
+    static constexpr std::size_t encoded = [] {
+        std::size_t n = 0;
+        while (n < count && exacts[n]) ++n;
+        return std::min(n + 1, count);
+    }();
+
+   public:
+    /**
+     * @brief Size of the key in bytes.
+     */
+    static constexpr std::size_t size = [] {
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < encoded; ++i) total += sizes[i];
+        return total;
+    }();
+
+    /**
+     * @brief `true` if comparing keys gives the exact order of records,
+     * `false` if records with equal keys still need to be compared.
+     */
+    static constexpr bool exact = encoded == count && exacts[count - 1];
+
+    using key_type = std::array<unsigned char, size>;
+
+    /**
+     * @brief Encode the key of `value`.
+     * @param value the record
+     * @return The key.
+     */
+    static key_type encode(const T &value) noexcept {
+        key_type key;
+        unsigned char *out = key.data();
+        std::size_t i = 0;
+        ((i < encoded ? (key_codec<type_of_member<T, Names>>::encode(
+                             member_of<Names>(value), out),
+                         out += sizes[i++])
+                      : out),
+         ...);
+        return key;
+    }
+
+    /**
+     * @brief Compare two records member by member.
+     * @return `true` if `lhs` is ordered before `rhs`.
+     */
+    static bool less(const T &lhs, const T &rhs) {
+        bool result = false;
+        ((member_less(member_of<Names>(lhs), member_of<Names>(rhs))
+              ? (result = true, false)
+              : !member_less(member_of<Names>(rhs), member_of<Names>(lhs))) &&
+         ...);
+        return result;
+    }
+};
+
+/**
+ * @brief Internal implementation of `sort_by`.
+ * Stable LSD radix sort of `(key, index)` pairs, one pass per key byte.
+ * @details Passes in which all keys have the same byte are skipped.
+ */
+template <typename Entry>
+void radix_sort(std::vector<Entry> &entries) {
+    constexpr std::size_t width = std::tuple_size_v<decltype(Entry::key)>;
+    std::vector<Entry> buffer(entries.size());
+    for (std::size_t byte = width; byte-- > 0;) {
+        std::array<std::size_t, 256> counts{};
+        for (const Entry &e : entries) ++counts[e.key[byte]];
+        if (counts[entries.front().key[byte]] == entries.size()) continue;
+        std::size_t offset = 0;
+        for (std::size_t &count : counts)
+            offset += std::exchange(count, offset);
+        for (Entry &e : entries) buffer[counts[e.key[byte]]++] = std::move(e);
+        entries.swap(buffer);
+    }
+}
+
+/**
+ * @brief Stable sort of a range of records by the members `Names...`.
+ * @details
+ * For example, `reflect::sort_by<"symbol", "ts">(ticks)` orders by `symbol`
+ * first and `ts` second. The sort key of every record is encoded once into
+ * a `sort_key`. If the key is exact, the keys are radix sorted; otherwise,
+ * the keys are compared with `memcmp` first and the records are compared
+ * only when their keys are equal. Only the keys and indices are moved while
+ * sorting; finally the records are moved into a buffer in sorted order and
+ * then back into the range.
+ * @tparam Names names of the members, the most significant first
+ * @tparam R DO NOT specify it, let it be automatically deduced
+ * @param range random access range of default-constructible aggregate type
+ */
+template <conststr::cstr... Names, std::ranges::random_access_range R>
+void sort_by(R &&range)
+    requires(sizeof...(Names) > 0) &&
+            (std::same_as<typename decltype(Names)::value_type, char> && ...) &&
+            std::ranges::sized_range<R>
+{
+    using T = std::ranges::range_value_t<R>;
+    using sort_key_t = sort_key<T, Names...>;
+    struct entry {
+        typename sort_key_t::key_type key;
+        std::size_t index;
+    };
+
+    const std::size_t count = std::ranges::size(range);
+    if (count < 2) return;
+    auto first = std::ranges::begin(range);
+    std::vector<entry> entries(count);
+    for (std::size_t i = 0; i < count; ++i)
+        entries[i] = {sort_key_t::encode(first[i]), i};
+
+    if constexpr (sort_key_t::exact)
+        radix_sort(entries);
+    else
+        std::stable_sort(entries.begin(), entries.end(),
+                         [&](const entry &lhs, const entry &rhs) {
+                             int cmp = std::memcmp(lhs.key.data(),
+                                                   rhs.key.data(),
+                                                   sort_key_t::size);
+                             if (cmp != 0) return cmp < 0;
+                             return sort_key_t::less(first[lhs.index],
+                                              first[rhs.index]);
+                         });
+
+    std::vector<T> sorted;
+    sorted.reserve(count);
+    for (const entry &e : entries) sorted.push_back(std::move(first[e.index]));
+    std::ranges::move(sorted, first);
+}
+}  // namespace reflect
+
+#endif
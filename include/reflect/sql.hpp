@@ -0,0 +1,208 @@
+/* MIT License
+ *
+ * Copyright (c) 2024 Nichts Hsu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * @file sql.hpp
+ * @brief Compile-time SQL statements for reflected records.
+ */
+
+#ifndef REFLECT_SQL_HPP
+#define REFLECT_SQL_HPP
+
+#include <utility>
+
+#include "../reflect.hpp"
+
+namespace reflect {
+/**
+ * @brief Compile-time SQL statements for reflected records.
+ * @details
+ * Statements are built as `conststr::cstr` from `name_of`, with one column
+ * per member and `?` placeholders. Column names are double-quoted, so members
+ * such as `order` or `key` are valid; the table name is written as given, so
+ * it may be schema-qualified or quoted by the caller. Store them in `constexpr` variables so that
+ * their text is a constant, whose address or `fnv1a` hash can key a
+ * prepared-statement cache:
+ * @code{.cpp}
+ * constexpr auto insert_user = reflect::sql::insert<User>("users"_cs);
+ * // INSERT INTO users ("id", "name", "email") VALUES (?, ?, ?)
+ * reflect::sql::bind(user, [&](std::size_t pos, const auto &value) {
+ *     stmt.bind(pos, value);
+ * });
+ * @endcode
+ */
+namespace sql {
+/**
+ * @brief Join strings with the separator `sep`.
+ * @param sep separator
+ * @param first first string
+ * @param rest other strings
+ * @return Joined string.
+ */
+template <typename Sep, typename First, typename... Rest>
+constexpr auto join(const Sep &sep, const First &first, const Rest &...rest) {
+    if constexpr (sizeof...(Rest) == 0)
+        return conststr::cstr(first);
+    else
+        return conststr::flatten(first, (conststr::cstr(sep) + rest)...);
+}
+
+/**
+ * @brief Internal implementation of `sql`.
+ * Indices `0, 1, ..., N - 1` of `T` without `Key`.
+ */
+template <typename T, std::size_t Key, std::size_t... Is>
+constexpr auto indices_without(std::index_sequence<Is...>) {
+    return std::index_sequence<(Is < Key ? Is : Is + 1)...>{};
+}
+
+/**
+ * @brief Member indices of `T` except the member named `Key`.
+ */
+template <typename T, conststr::cstr Key>
+using non_key_indices = decltype(indices_without<T, index_of<T, Key>>(
+    std::make_index_sequence<number_of_members<T> - 1>{}));
+
+/**
+ * @brief Double-quoted name of the I-th member of `T`.
+ */
+template <typename T, std::size_t I>
+constexpr auto column_of = conststr::flatten("\"", name_of<T, I>, "\"");
+
+/**
+ * @brief Comma-separated names of the members `Is` of `T`.
+ */
+template <typename T, std::size_t... Is>
+constexpr auto columns(std::index_sequence<Is...> = {}) {
+    return join(", ", column_of<T, Is>...);
+}
+
+/**
+ * @brief Comma-separated list of N placeholders.
+ */
+template <std::size_t... Is>
+constexpr auto placeholders(std::index_sequence<Is...>) {
+    return join(", ", ((void)Is, conststr::cstr("?"))...);
+}
+
+/**
+ * @brief Get the statement inserting one record of `T`.
+ * @details
+ * For example, `INSERT INTO users ("id", "name") VALUES (?, ?)`.
+ * Parameters are bound by `bind`.
+ * @tparam T default-constructible aggregate type
+ * @param table name of the table
+ * @return SQL text.
+ */
+template <reflectable T, std::size_t N, typename V>
+constexpr auto insert(const conststr::cstr<N, char, V> &table) {
+    constexpr auto all = std::make_index_sequence<number_of_members<T>>{};
+    return conststr::flatten("INSERT INTO ", table, " (", columns<T>(all),
+                             ") VALUES (", placeholders(all), ")");
+}
+
+/**
+ * @brief Get the statement selecting all records of `T`.
+ * @details
+ * For example, `SELECT "id", "name" FROM users`.
+ * @tparam T default-constructible aggregate type
+ * @param table name of the table
+ * @return SQL text.
+ */
+template <reflectable T, std::size_t N, typename V>
+constexpr auto select(const conststr::cstr<N, char, V> &table) {
+    constexpr auto all = std::make_index_sequence<number_of_members<T>>{};
+    return conststr::flatten("SELECT ", columns<T>(all), " FROM ", table);
+}
+
+/**
+ * @brief Get the statement selecting records of `T` by the member `Key`.
+ * @details
+ * For example, `SELECT "id", "name" FROM users WHERE "id" = ?`.
+ * @tparam T default-constructible aggregate type
+ * @tparam Key name of the key member
+ * @param table name of the table
+ * @return SQL text.
+ */
+template <reflectable T, conststr::cstr Key, std::size_t N, typename V>
+constexpr auto select(const conststr::cstr<N, char, V> &table)
+    requires std::same_as<typename decltype(Key)::value_type, char>
+{
+    return conststr::flatten(select<T>(table), " WHERE ",
+                             column_of<T, index_of<T, Key>>, " = ?");
+}
+
+/**
+ * @brief Get the statement updating a record of `T` by the member `Key`.
+ * @details
+ * For example, `UPDATE users SET "name" = ?, "email" = ? WHERE "id" = ?`.
+ * Parameters are bound by `bind_update<Key>`.
+ * @tparam T default-constructible aggregate type
+ * @tparam Key name of the key member
+ * @param table name of the table
+ * @return SQL text.
+ */
+template <reflectable T, conststr::cstr Key, std::size_t N, typename V>
+constexpr auto update(const conststr::cstr<N, char, V> &table)
+    requires std::same_as<typename decltype(Key)::value_type, char>
+{
+    static_assert(number_of_members<T> > 1, "nothing to update besides key");
+    return [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+        return conststr::flatten(
+            "UPDATE ", table, " SET ",
+            join(", ", (column_of<T, Is> + conststr::cstr(" = ?"))...),
+            " WHERE ", column_of<T, index_of<T, Key>>, " = ?");
+    }(non_key_indices<T, Key>{});
+}
+
+/**
+ * @brief Bind the members of `obj` as the parameters of `insert<T>`.
+ * @param obj object of default-constructible aggregate type
+ * @param f callable accepting the 1-based parameter position and the member
+ */
+template <reflectable T, typename F>
+constexpr void bind(const T &obj, F &&f) {
+    [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+        (f(Is + 1, member_of<Is>(obj)), ...);
+    }(std::make_index_sequence<number_of_members<T>>{});
+}
+
+/**
+ * @brief Bind the members of `obj` as the parameters of `update<T, Key>`.
+ * @details Non-key members are bound in member order, then the key member.
+ * @tparam Key name of the key member
+ * @param obj object of default-constructible aggregate type
+ * @param f callable accepting the 1-based parameter position and the member
+ */
+template <conststr::cstr Key, reflectable T, typename F>
+constexpr void bind_update(const T &obj, F &&f) {
+    [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+        std::size_t pos = 0;
+        (f(++pos, member_of<Is>(obj)), ...);
+        f(++pos, member_of<Key>(obj));
+    }(non_key_indices<T, Key>{});
+}
+}  // namespace sql
+}  // namespace reflect
+
+#endif
@@ -0,0 +1,212 @@
+/* MIT License
+ *
+ * Copyright (c) 2024 Nichts Hsu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * @file tracked.hpp
+ * @brief Aggregate wrapper recording which members have been written.
+ */
+
+#ifndef REFLECT_TRACKED_HPP
+#define REFLECT_TRACKED_HPP
+
+#include <array>
+#include <concepts>
+#include <cstdint>
+#include <utility>
+
+#include "../reflect.hpp"
+
+namespace reflect {
+/**
+ * @brief Wrapper of an object of type `T` with one dirty bit per member.
+ * @details
+ * Members can only be written through `set`, which marks them dirty.
+ * `for_each_dirty` visits the dirty members, so that only those need to be
+ * persisted. For example:
+ * @code{.cpp}
+ * reflect::tracked<User> user(load_user(id));
+ * user.set<"email">("new@example.com");
+ * user.for_each_dirty([&](auto name, const auto &value) {
+ *     db.update_column(id, name, value);
+ * });
+ * user.clear();
+ * @endcode
+ * @tparam T default-constructible aggregate type
+ */
+template <reflectable T>
+class tracked {
+   public:
+    using value_type = T;
+
+    /**
+     * @brief Number of members, also the number of dirty bits.
+     */
+    static constexpr std::size_t size = number_of_members<T>;
+
+    /**
+     * @brief Dirty bits, bit `N % 64` of word `N / 64` for the N-th member.
+     */
+    using mask_type = std::array<std::uint64_t, (size + 63) / 64>;
+
+    /**
+     * @brief Construct a value-initialized object with no dirty member.
+     */
+    constexpr tracked() = default;
+
+    /**
+     * @brief Wrap `value` with no dirty member.
+     */
+    constexpr explicit tracked(T value) : _value(std::move(value)) {}
+
+    /**
+     * @brief Get the wrapped object.
+     */
+    constexpr const T &value() const noexcept { return _value; }
+
+    /**
+     * @brief Get the wrapped object.
+     */
+    constexpr const T *operator->() const noexcept { return &_value; }
+
+    /**
+     * @brief Get the N-th member.
+     * @tparam N index of member
+     */
+    template <std::size_t N>
+    constexpr const auto &get() const noexcept {
+        return member_of<N>(_value);
+    }
+
+    /**
+     * @brief Get the member via its name.
+     * @tparam Name name of member
+     */
+    template <conststr::cstr Name>
+    constexpr const auto &get() const noexcept
+        requires std::same_as<typename decltype(Name)::value_type, char>
+    {
+        return member_of<Name>(_value);
+    }
+
+    /**
+     * @brief Assign the N-th member and mark it dirty.
+     * @tparam N index of member
+     * @param value new value
+     */
+    template <std::size_t N, typename V>
+    constexpr void set(V &&value)
+        requires std::assignable_from<type_of<T, N> &, V>
+    {
+        member_of<N>(_value) = std::forward<V>(value);
+        _dirty[N / 64] |= std::uint64_t(1) << (N % 64);
+    }
+
+    /**
+     * @brief Assign the member via its name and mark it dirty.
+     * @tparam Name name of member
+     * @param value new value
+     */
+    template <conststr::cstr Name, typename V>
+    constexpr void set(V &&value)
+        requires std::same_as<typename decltype(Name)::value_type, char> &&
+                 std::assignable_from<type_of_member<T, Name> &, V>
+    {
+        set<index_of<T, Name>>(std::forward<V>(value));
+    }
+
+    /**
+     * @brief Check whether the N-th member is dirty.
+     * @tparam N index of member
+     */
+    template <std::size_t N>
+    constexpr bool dirty() const noexcept {
+        return test(N);
+    }
+
+    /**
+     * @brief Check whether the member is dirty via its name.
+     * @tparam Name name of member
+     */
+    template <conststr::cstr Name>
+    constexpr bool dirty() const noexcept
+        requires std::same_as<typename decltype(Name)::value_type, char>
+    {
+        return test(index_of<T, Name>);
+    }
+
+    /**
+     * @brief Check whether any member is dirty.
+     */
+    constexpr bool dirty() const noexcept {
+        for (std::uint64_t word : _dirty)
+            if (word != 0) return true;
+        return false;
+    }
+
+    /**
+     * @brief Get the dirty bits.
+     */
+    constexpr const mask_type &dirty_bits() const noexcept { return _dirty; }
+
+    /**
+     * @brief Mark all members dirty, e.g. to force a full write.
+     */
+    constexpr void mark_all() noexcept {
+        _dirty.fill(~std::uint64_t(0));
+        if constexpr (size % 64 != 0)
+            _dirty.back() = (std::uint64_t(1) << (size % 64)) - 1;
+    }
+
+    /**
+     * @brief Mark all members clean, e.g. after they have been persisted.
+     */
+    constexpr void clear() noexcept { _dirty.fill(0); }
+
+    /**
+     * @brief Call `f(name, value)` for each dirty member, in member order.
+     * @param f callable accepting the `name_of` name of the member as a
+     * `conststr::cstr` and a const reference to the member
+     */
+    template <typename F>
+    constexpr void for_each_dirty(F &&f) const {
+        if (!dirty()) return;
+        [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            (
+                [&] {
+                    if (test(Is)) f(name_of<T, Is>, member_of<Is>(_value));
+                }(),
+                ...);
+        }(std::make_index_sequence<size>{});
+    }
+
+   private:
+    constexpr bool test(std::size_t n) const noexcept {
+        return (_dirty[n / 64] >> (n % 64)) & 1;
+    }
+
+    T _value{};
+    mask_type _dirty{};
+};
+}  // namespace reflect
+
+#endif
@@ -0,0 +1,71 @@
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "reflect/aggregate.hpp"
+
+struct Order {
+    std::uint64_t id;
+    char side;
+    double price;
+    std::int32_t qty;
+};
+
+int main() {
+    std::vector<Order> orders;
+    for (std::int32_t i = 0; i < 1000; ++i)
+        orders.push_back({std::uint64_t(i), i % 2 ? 'B' : 'S', 0.25 * i,
+                          i - 500});
+
+    static_assert(std::same_as<decltype(reflect::sum<"qty">(orders)),
+                               std::int64_t>);
+    if (reflect::sum<"price">(orders) != 0.25 * 999 * 1000 / 2) return 1;
+    if (reflect::sum<"qty">(orders) != -500) return 1;
+    if (reflect::min<"qty">(orders) != -500) return 1;
+    if (reflect::max<"price">(orders) != 0.25 * 999) return 1;
+    if (reflect::mean<"id">(orders) != 499.5) return 1;
+    if (reflect::count_if<"side">(orders, [](char c) { return c == 'B'; }) !=
+        500)
+        return 1;
+
+    const auto &corders = orders;
+    auto ids = reflect::column<0>(corders);
+    static_assert(std::same_as<decltype(ids[0]), std::uint64_t>);
+    static_assert(std::random_access_iterator<decltype(ids.begin())>);
+    static_assert(std::random_access_iterator<
+                  decltype(reflect::column<"qty">(orders).begin())>);
+    if (ids.size() != 1000 || ids[999] != 999) return 1;
+    reflect::column<"qty">(orders)[0] = 0;
+    if (orders[0].qty != 0) return 1;
+
+    // Contiguous column and parallel chunks
+    std::vector<double> prices(100003);
+    for (std::size_t i = 0; i < prices.size(); ++i) prices[i] = double(i % 7);
+    reflect::strided_view<const double> view(
+        reinterpret_cast<const std::byte *>(prices.data()), sizeof(double),
+        prices.size());
+    double expected = reflect::sum(view);
+    reflect::parallel policy{4, 1000};
+    if (reflect::sum(view, policy) != expected) return 1;
+    if (reflect::max(view, policy) != 6.0) return 1;
+    if (reflect::count_if(view, [](double v) { return v == 0; }, policy) !=
+        14287)
+        return 1;
+    if (reflect::sum<"price">(orders, policy) != 0.25 * 999 * 1000 / 2)
+        return 1;
+
+    // Elements need not be aligned.
+    std::vector<std::byte> packed(1 + 3 * sizeof(double));
+    reflect::strided_view<double> unaligned(packed.data() + 1, sizeof(double),
+                                            3);
+    for (std::size_t i = 0; i < 3; ++i) unaligned[i] = 1.5 * double(i);
+    unaligned[0] = unaligned[2];
+    if (reflect::sum(unaligned) != 7.5) return 1;
+
+    std::vector<Order> empty;
+    if (reflect::min<"price">(empty) || reflect::mean<"qty">(empty)) return 1;
+
+    std::cout << __FILE__ ": all tests passed." << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,54 @@
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+#include "reflect/buffer_view.hpp"
+
+struct Quote {
+    std::uint32_t bid;
+    std::uint32_t ask;
+};
+
+struct Tick {
+    std::uint64_t ts;
+    char flag;
+    double price;
+    Quote quote;
+    std::int16_t levels[4];
+};
+
+int main() {
+    // Deliberately misaligned storage
+    alignas(8) std::array<std::byte, sizeof(Tick) + 1> storage{};
+    std::span<std::byte> bytes(storage.data() + 1, sizeof(Tick));
+
+    Tick tick = {1700000000, 'B', 99.5, {10, 12}, {1, 2, 3, 4}};
+    std::memcpy(bytes.data(), &tick, sizeof(Tick));
+
+    reflect::buffer_view<Tick> view(bytes);
+    static_assert(std::same_as<decltype(view.get<"price">()), double>);
+    if (view.get<0>() != 1700000000) return 1;
+    if (view.get<"flag">() != 'B') return 1;
+    if (view.get<"price">() != 99.5) return 1;
+    if (view.get<"levels">(2) != 3) return 1;
+    if (view.view<"quote">().get<"ask">() != 12) return 1;
+    if (view.get<"quote">().bid != 10) return 1;
+
+    reflect::mutable_buffer_view<Tick> mview(bytes);
+    mview.set<"price">(101.25);
+    mview.set<1>('S');
+    mview.set<"levels">(0, std::int16_t(-7));
+    mview.view<"quote">().set<"bid">(11);
+    Tick loaded = view.load();
+    if (loaded.price != 101.25 || loaded.flag != 'S') return 1;
+    if (loaded.levels[0] != -7 || loaded.quote.bid != 11) return 1;
+    if (loaded.ts != tick.ts || loaded.quote.ask != 12) return 1;
+
+    mview.store(tick);
+    if (view.get<"price">() != 99.5) return 1;
+
+    std::cout << __FILE__ ": all tests passed." << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,125 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "conststr/charclass.hpp"
+
+using namespace conststr::literal;
+namespace charutils = conststr::charutils;
+
+template <auto Pred>
+constexpr bool matches_predicate() {
+    constexpr charutils::table<Pred> table;
+    for (int ch = 0; ch < 256; ++ch) {
+        bool expected = Pred(char(ch));
+        if (table(char(ch)) != expected) return false;
+        auto lo = table.nibble_lo[ch & 15], hi = table.nibble_hi[ch >> 4];
+        if (table.nibble_exact && bool(lo & hi) != expected) return false;
+    }
+    return true;
+}
+
+template <auto Pred>
+bool scans_like_predicate(std::string_view str) {
+    constexpr charutils::table<Pred> table;
+    for (std::size_t pos = 0; pos <= str.size(); ++pos) {
+        std::size_t found = std::string_view::npos, missed = found;
+        for (std::size_t i = pos; i < str.size(); ++i)
+            if (Pred(str[i])) {
+                if (found == std::string_view::npos) found = i;
+            } else if (missed == std::string_view::npos) {
+                missed = i;
+            }
+        if (table.find(str, pos) != found) return false;
+        if (table.find_not(str, pos) != missed) return false;
+    }
+    return true;
+}
+
+template <char... Chs>
+bool sets_like_string_view(std::string_view str) {
+    const char set[] = {Chs..., '\0'};
+    for (std::size_t pos = 0; pos <= str.size() + 1; ++pos) {
+        if (conststr::find_first_of<Chs...>(str, pos) !=
+            str.find_first_of(set, pos))
+            return false;
+        if (conststr::find_first_not_of<Chs...>(str, pos) !=
+            str.find_first_not_of(set, pos))
+            return false;
+        if (conststr::find_last_of<Chs...>(str, pos) !=
+            str.find_last_of(set, pos))
+            return false;
+        if (conststr::find_last_not_of<Chs...>(str, pos) !=
+            str.find_last_not_of(set, pos))
+            return false;
+    }
+    return true;
+}
+
+constexpr auto is_quote = [](char ch) { return ch == '"' || ch == '\''; };
+constexpr auto is_high = [](char ch) { return (unsigned char)ch >= 0x80; };
+// 16 distinct columns, no nibble encoding
+constexpr auto is_diagonal = [](char ch) {
+    return ((unsigned char)ch >> 4) == ((unsigned char)ch & 15);
+};
+
+int main() {
+    static_assert(matches_predicate<charutils::isalnum<char>>());
+    static_assert(matches_predicate<charutils::isxdigit<char>>());
+    static_assert(matches_predicate<charutils::ispunct<char>>());
+    static_assert(matches_predicate<charutils::isspace<char>>());
+    static_assert(matches_predicate<charutils::iscntrl<char>>());
+    static_assert(matches_predicate<charutils::isprint<char>>());
+    static_assert(matches_predicate<is_quote>());
+    static_assert(matches_predicate<is_high>());
+    static_assert(matches_predicate<is_diagonal>());
+
+    static_assert(charutils::table<charutils::isalnum<char>>::nibble_exact);
+    static_assert(charutils::table<charutils::ispunct<char>>::nibble_exact);
+    static_assert(charutils::table<charutils::iscntrl<char>>::nibble_exact);
+    static_assert(!charutils::table<is_diagonal>::nibble_exact);
+    static_assert(charutils::table<charutils::isxdigit<char>>::size == 22);
+    static_assert(charutils::table<is_high>::size == 128);
+
+    constexpr charutils::table<charutils::isdigit<char>> digit;
+    static_assert("abc123"_cs.find_if(digit) == 3);
+    static_assert(digit.find("abc123") == 3);
+    static_assert(digit.find_not("123abc", 1) == 3);
+
+    std::string text =
+        "int main() { return 0x1F + value_2; }\t\n\"quoted\" \xC3\xA9t\xC3\xA9 "
+        "and a long_identifier_spanning_more_than_sixteen_bytes";
+    if (!scans_like_predicate<charutils::isalnum<char>>(text)) return 1;
+    if (!scans_like_predicate<charutils::isspace<char>>(text)) return 1;
+    if (!scans_like_predicate<is_quote>(text)) return 1;
+    if (!scans_like_predicate<is_high>(text)) return 1;
+    if (!scans_like_predicate<is_diagonal>(text)) return 1;
+
+    static_assert(conststr::find_first_of<',', ';'>("a;b,c"_cs) == 1);
+    static_assert(conststr::find_first_not_of<' '>("  x ") == 2);
+    static_assert(conststr::find_last_of<'/'>("usr/local/bin") == 9);
+    static_assert(conststr::find_last_not_of<' ', '\n'>("x \n") == 0);
+    static_assert(conststr::find_first_of<'z'>("abc") == std::string::npos);
+    static_assert(conststr::span_of<' ', '\t'>(" \t x") == 3);
+    static_assert(conststr::span_of<'a'>("aaa") == 3);
+    static_assert(conststr::span_of<'a'>("aaa", 5) == 0);
+    static_assert(conststr::rspan_of<'0'>("1000") == 3);
+    static_assert(conststr::rspan_of<'0'>("000") == 3);
+
+    if (!sets_like_string_view<','>(text)) return 1;
+    if (!sets_like_string_view<' ', '\t', '\n'>(text)) return 1;
+    if (!sets_like_string_view<'a', 'e', 'i', 'o', 'u', '_', '(', ')', '{',
+                               '}', ';'>(text))
+        return 1;
+    if (!sets_like_string_view<'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i',
+                               'j', 'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r',
+                               's', 't', 'u'>(text))
+        return 1;
+    std::string spaces(40, ' ');
+    if (conststr::span_of<' '>(spaces) != 40) return 1;
+    if (conststr::rspan_of<' '>(text + spaces) != 40) return 1;
+
+    std::cout << __FILE__ ": all tests passed." << std::endl;
+
+    return 0;
+}
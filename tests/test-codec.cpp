@@ -0,0 +1,72 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "conststr/codec.hpp"
+
+using namespace conststr::literal;
+
+template <conststr::cstr Expected>
+constexpr bool same(const auto &str) {
+    return std::string_view(str) == std::string_view(Expected);
+}
+
+std::string as_string(const std::vector<std::byte> &bytes) {
+    return {reinterpret_cast<const char *>(bytes.data()), bytes.size()};
+}
+
+int main() {
+    static_assert(same<""_cs>(conststr::base64_encode<""_cs>()));
+    static_assert(same<"Zg=="_cs>(conststr::base64_encode<"f"_cs>()));
+    static_assert(same<"Zm8="_cs>(conststr::base64_encode<"fo"_cs>()));
+    static_assert(same<"Zm9vYmFy"_cs>(conststr::base64_encode<"foobar"_cs>()));
+    static_assert(same<"foob"_cs>(conststr::base64_decode<"Zm9vYg=="_cs>()));
+    static_assert(same<"fooba"_cs>(conststr::base64_decode<"Zm9vYmE="_cs>()));
+    static_assert(conststr::base64_decode<"/+8A"_cs>().size() == 3);
+    static_assert(conststr::base64_decode<"/+8A"_cs>()[0] == '\xFF');
+    static_assert(same<"00ff7f"_cs>(conststr::hex_encode<"\0\xFF\x7F"_cs>()));
+    static_assert(same<"\xDE\xAD\xBE\xEF"_cs>(
+        conststr::hex_decode<"deADbeEF"_cs>()));
+    static_assert(conststr::base64_decoded_size("abc") ==
+                  std::string_view::npos);
+
+    std::string data;
+    for (int i = 0; i < 300; ++i) data += char(i * 7 + i / 5);
+    for (std::size_t size = 0; size <= data.size(); ++size) {
+        std::string_view part(data.data(), size);
+        std::string encoded = conststr::base64_encode(part);
+        std::string reference(encoded.size(), '\0');
+        conststr::base64_encode_scalar(part, reference.data());
+        if (encoded != reference) return 1;
+        if (as_string(conststr::base64_decode(encoded)) != part) return 1;
+
+        std::string hex = conststr::hex_encode(part);
+        if (hex.size() != size * 2) return 1;
+        if (as_string(conststr::hex_decode(hex)) != part) return 1;
+        for (auto &ch : hex) ch = conststr::charutils::toupper(ch);
+        if (as_string(conststr::hex_decode(hex)) != part) return 1;
+    }
+
+    auto rejects = [](auto decode, std::string_view in) {
+        try {
+            decode(in);
+        } catch (const std::runtime_error &) {
+            return true;
+        }
+        return false;
+    };
+    auto base64 = [](std::string_view in) { conststr::base64_decode(in); };
+    auto hex = [](std::string_view in) { conststr::hex_decode(in); };
+    std::string long_base64 = conststr::base64_encode(data);
+    if (!rejects(base64, "Zm9")) return 1;
+    if (!rejects(base64, "Zm=v")) return 1;
+    if (!rejects(base64, "Z===")) return 1;
+    if (!rejects(base64, long_base64.replace(20, 1, "-"))) return 1;
+    std::string long_hex = conststr::hex_encode(data);
+    if (!rejects(hex, "abc")) return 1;
+    if (!rejects(hex, long_hex.replace(40, 1, "g"))) return 1;
+
+    std::cout << __FILE__ ": all tests passed." << std::endl;
+
+    return 0;
+}
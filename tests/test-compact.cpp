@@ -0,0 +1,175 @@
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "reflect/compact.hpp"
+
+enum class Level : std::uint8_t { low, mid, high };
+
+struct Reading {
+    std::int32_t delta;
+    std::uint16_t sensor;
+    bool ok;
+    Level level;
+    float temp;
+    double pressure;
+};
+
+struct Packet {
+    std::uint64_t id;
+    std::string host;
+    Reading reading;
+};
+
+struct PacketV2 {
+    std::uint64_t id;
+    std::int64_t sequence;
+    std::string host;
+};
+
+template <>
+struct reflect::compact::tags<PacketV2>
+    : reflect::compact::tag_map<reflect::compact::tag<"host", 2>,
+                                reflect::compact::tag<"sequence", 9>> {};
+
+struct Label {
+    char name[4];
+    std::uint8_t weight;
+};
+
+struct Small {
+    std::int8_t value;
+};
+
+struct Large {
+    std::int64_t value;
+};
+
+struct Name {
+    std::string name;
+    std::uint64_t weight;
+};
+
+struct Letter {
+    char ch;
+};
+
+struct Byte {
+    std::uint8_t value;
+};
+
+template <int Depth>
+struct Chain {
+    Chain<Depth - 1> inner;
+    std::uint8_t depth = Depth;
+};
+
+template <>
+struct Chain<0> {
+    std::uint8_t depth = 0;
+};
+
+namespace compact = reflect::compact;
+
+int main() {
+    static_assert(compact::zigzag(-1) == 1);
+    static_assert(compact::zigzag(1) == 2);
+    static_assert(compact::unzigzag(compact::zigzag(-123456789)) == -123456789);
+    static_assert(compact::varint_size(127) == 1);
+    static_assert(compact::varint_size(128) == 2);
+    static_assert(compact::tag_of<Packet, 1> == 2);
+    static_assert(compact::tag_of<PacketV2, 1> == 9);
+    static_assert(compact::tag_of<PacketV2, 2> == 2);
+    static_assert(compact::key_of<Packet, 1>.size == 1);
+    static_assert(compact::key_of<Packet, 1>.data[0] == std::byte(0x12));
+
+    Reading r{-3, 7, true, Level::high, 21.5f, 1013.25};
+    auto bytes = compact::encode(r);
+    // keys are 1 byte each, small varints 1 byte, float 4, double 8
+    if (bytes.size() != 6 + 4 + 4 + 8) return 1;
+    if (bytes[0] != std::byte(0x08) || bytes[1] != std::byte(0x05)) return 1;
+    Reading r2 = compact::decode<Reading>(bytes);
+    if (r2.delta != -3 || r2.sensor != 7 || !r2.ok || r2.level != Level::high ||
+        r2.temp != 21.5f || r2.pressure != 1013.25)
+        return 1;
+
+    Reading zero{};
+    if (!compact::encode(zero).empty()) return 1;
+
+    Packet p{300, "edge-01", {5, 0, false, Level::low, 0.0f, 0.0}};
+    auto pb = compact::encode(p);
+    if (pb.size() != compact::encoded_size(p)) return 1;
+    Packet p2 = compact::decode<Packet>(pb);
+    if (p2.id != 300 || p2.host != "edge-01" || p2.reading.delta != 5)
+        return 1;
+
+    // Packet and PacketV2 share tags 1 and 2, unknown tags are skipped.
+    PacketV2 v2 = compact::decode<PacketV2>(pb);
+    if (v2.id != 300 || v2.host != "edge-01" || v2.sequence != 0) return 1;
+    PacketV2 v2b{1, -42, "db"};
+    Packet p3 = compact::decode<Packet>(compact::encode(v2b));
+    if (p3.id != 1 || p3.host != "db") return 1;
+    if (compact::decode<PacketV2>(compact::encode(v2b)).sequence != -42)
+        return 1;
+
+    bool thrown = false;
+    try {
+        pb.pop_back();
+        compact::decode<Packet>(pb);
+    } catch (const std::runtime_error &) {
+        thrown = true;
+    }
+    if (!thrown) return 1;
+
+    Label label{"abc", 200};
+    Label label2 = compact::decode<Label>(compact::encode(label));
+    if (std::string_view(label2.name) != "abc" || label2.weight != 200)
+        return 1;
+    Label full{{'w', 'x', 'y', 'z'}, 1};
+    if (compact::encoded_size(full) != 2 + 4 + 2) return 1;
+    Name name = compact::decode<Name>(compact::encode(full));
+    if (name.name != "wxyz" || name.weight != 1) return 1;
+    label2 = compact::decode<Label>(compact::encode(name));
+    if (std::string_view(label2.name, 4) != "wxyz") return 1;
+
+    // Strings longer than a char[N] and integers out of range are rejected.
+    for (Name bad : {Name{"abcde", 0}, Name{"", 256}}) {
+        thrown = false;
+        try {
+            compact::decode<Label>(compact::encode(bad));
+        } catch (const std::runtime_error &) {
+            thrown = true;
+        }
+        if (!thrown) return 1;
+    }
+    if (compact::decode<Small>(compact::encode(Large{-128})).value != -128)
+        return 1;
+    thrown = false;
+    try {
+        compact::decode<Small>(compact::encode(Large{128}));
+    } catch (const std::runtime_error &) {
+        thrown = true;
+    }
+    if (!thrown) return 1;
+
+    // Plain char is encoded as unsigned char whatever its signedness.
+    auto eacute = compact::encode(Letter{char(0xE9)});
+    const std::vector<std::byte> expected_eacute = {
+        std::byte(0x08), std::byte(0xE9), std::byte(0x01)};
+    if (eacute != expected_eacute) return 1;
+    if (compact::decode<Letter>(eacute).ch != char(0xE9)) return 1;
+    if (compact::decode<Byte>(eacute).value != 0xE9) return 1;
+
+    // Every nested record is measured once, not once per enclosing level.
+    Chain<40> chain;
+    auto cb = compact::encode(chain);
+    if (cb.size() != compact::encoded_size(chain)) return 1;
+    Chain<40> chain2 = compact::decode<Chain<40>>(cb);
+    if (chain2.depth != 40 || chain2.inner.inner.depth != 38) return 1;
+
+    std::cout << __FILE__ ": all tests passed." << std::endl;
+
+    return 0;
+}
@@ -116,6 +116,12 @@ int main() {
     static_assert(std::same_as<decltype(to_char_str_span)::view_type,
                                std::span<const char>>);
 
+#ifdef __cpp_lib_format
+    // Format
+    if (std::format("[{}|{:>7}]", hello, "world"_cs) != "[hello|  world]")
+        return 1;
+#endif
+
     std::cout << __FILE__ ": all tests passed." << std::endl;
 
     return 0;
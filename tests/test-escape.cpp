@@ -0,0 +1,64 @@
+#include <iostream>
+#include <string>
+
+#include "conststr/escape.hpp"
+
+using namespace conststr::literal;
+
+template <conststr::cstr Expected>
+constexpr bool same(const auto &str) {
+    return std::string_view(str) == std::string_view(Expected);
+}
+
+constexpr auto key = conststr::escape_json<"say \"hi\"\n"_cs>();
+
+template <typename Escaper>
+constexpr bool scans_by_nibbles =
+    conststr::charutils::table<Escaper::needs>::nibble_exact;
+
+int main() {
+    static_assert(scans_by_nibbles<conststr::json_escaper>);
+    static_assert(scans_by_nibbles<conststr::c_escaper>);
+    static_assert(scans_by_nibbles<conststr::html_escaper>);
+    static_assert(scans_by_nibbles<conststr::url_escaper>);
+
+    static_assert(key.size() == 12);
+    static_assert(same<R"(say \"hi\"\n)"_cs>(key));
+    static_assert(same<R"(\u0001\\\t)"_cs>(
+        conststr::escape_json<"\x01\\\t"_cs>()));
+    static_assert(conststr::escape_json<""_cs>().size() == 0);
+    static_assert(same<R"(tab\t\"q\" \033\377)"_cs>(
+        conststr::escape_c<"tab\t\"q\" \x1B\xFF"_cs>()));
+    static_assert(same<"&lt;a href=&quot;x&quot;&gt;Tom &amp; Jerry&#39;s"_cs>(
+        conststr::escape_html<"<a href=\"x\">Tom & Jerry's"_cs>()));
+    static_assert(same<"a%20b%2Fc%3F~x_y.z-%C3%A9"_cs>(
+        conststr::url_encode<"a b/c?~x_y.z-\xC3\xA9"_cs>()));
+
+    std::string clean(100, 'x');
+    if (conststr::escape_json(clean) != clean) return 1;
+    std::string dirty = clean + "\"" + clean + "\x1F\n" + "\xC3\xA9";
+    if (conststr::escape_json(dirty) !=
+        clean + "\\\"" + clean + "\\u001F\\n" + "\xC3\xA9")
+        return 1;
+    std::string out = "{\"k\":\"";
+    conststr::escape_json("a\\b", out);
+    if (out != "{\"k\":\"a\\\\b") return 1;
+    if (conststr::escape_c("line\n\x7F") != "line\\n\\177") return 1;
+    if (conststr::escape_html(clean + "<>") != clean + "&lt;&gt;") return 1;
+    if (conststr::url_encode("key=value & more") != "key%3Dvalue%20%26%20more")
+        return 1;
+
+    for (int ch = 0; ch < 256; ++ch) {
+        std::string byte(1, char(ch));
+        if (conststr::escape_json(byte).size() !=
+            conststr::json_escaper::size(char(ch)))
+            return 1;
+        if (conststr::url_encode(byte).size() !=
+            conststr::url_escaper::size(char(ch)))
+            return 1;
+    }
+
+    std::cout << __FILE__ ": all tests passed." << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,144 @@
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+#if defined(_WIN32)
+int main() {
+    std::cout << __FILE__ ": skipped, writev is not available." << std::endl;
+    return 0;
+}
+#else
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <system_error>
+
+#include "conststr/gather_writer.hpp"
+
+using namespace conststr::literal;
+
+static std::string read_all(std::FILE *file) {
+    std::fflush(file);
+    std::rewind(file);
+    std::string content;
+    char buffer[256];
+    std::size_t n;
+    while ((n = std::fread(buffer, 1, sizeof(buffer), file)) > 0)
+        content.append(buffer, n);
+    return content;
+}
+
+template <typename Writer>
+static std::string emit(Writer &out, std::FILE *file, int lines) {
+    std::string expected;
+    std::string body(100, 'x');
+    for (int i = 0; i < lines; ++i) {
+        std::string id = std::to_string(i);
+        out.template append<"id="_cs>();
+        out.stage(id);
+        out.template append<" body="_cs>();
+        out.append(body);
+        out.template append<"\n"_cs>();
+        expected += "id=" + id + " body=" + body + "\n";
+        if (i % 7 == 6) out.flush();
+    }
+    out.flush();
+    if (out.pending() != 0) return "pending";
+    return read_all(file) == expected ? "" : "mismatch";
+}
+
+static std::string drain(int fd) {
+    std::string content;
+    char buffer[4096];
+    ssize_t n;
+    while ((n = ::read(fd, buffer, sizeof(buffer))) > 0)
+        content.append(buffer, std::size_t(n));
+    return content;
+}
+
+int main() {
+    {
+        std::FILE *file = std::tmpfile();
+        conststr::io::gather_writer<> out(fileno(file));
+        out.append<"a"_cs>();
+        out.append<"b"_cs>();
+        out.append(std::string_view("c"));
+        // small fragments are merged into one staged iovec
+        if (out.fragments() != 1 || out.pending() != 3) return 1;
+        std::string big(200, 'y');
+        out.append(big);
+        out.append<"z"_cs>();
+        if (out.fragments() != 3) return 1;
+        out.flush();
+        if (read_all(file) != "abc" + big + "z") return 1;
+        std::fclose(file);
+    }
+    {
+        std::FILE *file = std::tmpfile();
+        conststr::io::gather_writer<> out(fileno(file));
+        if (!emit(out, file, 50).empty()) return 1;
+        std::fclose(file);
+    }
+    {
+        // fixed capacity flushes on its own when full
+        std::FILE *file = std::tmpfile();
+        conststr::io::gather_writer<4, 16> out(fileno(file), 8);
+        if (!emit(out, file, 50).empty()) return 1;
+        std::fclose(file);
+    }
+
+    {
+        // oversized staged fragments are written immediately
+        std::FILE *file = std::tmpfile();
+        conststr::io::gather_writer<4, 16> out(fileno(file), 8);
+        out.append<"head:"_cs>();
+        std::string big(40, 'q');
+        out.stage(big);
+        big.assign(40, '!');
+        if (out.pending() != 0) return 1;
+        out.append<":tail"_cs>();
+        out.flush();
+        if (read_all(file) != "head:" + std::string(40, 'q') + ":tail")
+            return 1;
+        std::fclose(file);
+    }
+    {
+        // a failed flush keeps only the bytes that were not written
+        int fds[2];
+        if (::pipe(fds) != 0) return 1;
+        ::fcntl(fds[0], F_SETFL, O_NONBLOCK);
+        ::fcntl(fds[1], F_SETFL, O_NONBLOCK);
+        std::string payload;
+        for (int i = 0; payload.size() < (1 << 20); ++i)
+            payload += std::to_string(i) + ',';
+        conststr::io::gather_writer<> out(fds[1]);
+        out.append<"<"_cs>();
+        out.append(payload);
+        out.append<">"_cs>();
+        std::string expected = "<" + payload + ">";
+        bool thrown = false;
+        try {
+            out.flush();
+        } catch (const std::system_error &) {
+            thrown = true;
+        }
+        if (!thrown) return 1;
+        std::string received = drain(fds[0]);
+        if (out.pending() != expected.size() - received.size()) return 1;
+        while (out.pending() != 0) {
+            try {
+                out.flush();
+            } catch (const std::system_error &) {
+            }
+            received += drain(fds[0]);
+        }
+        if (received != expected) return 1;
+        ::close(fds[0]);
+        ::close(fds[1]);
+    }
+
+    std::cout << __FILE__ ": all tests passed." << std::endl;
+
+    return 0;
+}
+#endif
@@ -0,0 +1,51 @@
+#include <iostream>
+#include <string>
+
+#include "conststr/glob.hpp"
+
+using conststr::glob;
+using namespace conststr::literal;
+
+int main() {
+    static_assert(glob<"*.log.[0-9]"_cs>("app.log.1"));
+    static_assert(!glob<"*.log.[0-9]"_cs>("app.log.x"));
+    static_assert(!glob<"*.log.[0-9]"_cs>("app.log.10"));
+    static_assert(glob<"*.log.[0-9]"_cs>(".log.0"));
+    static_assert(glob<"*.log.[0-9]"_cs>.segments == 2);
+
+    static_assert(glob<"abc"_cs>("abc"));
+    static_assert(!glob<"abc"_cs>("abcd"));
+    static_assert(glob<""_cs>(""));
+    static_assert(!glob<""_cs>("a"));
+    static_assert(glob<"*"_cs>(""));
+    static_assert(glob<"**"_cs>("anything"));
+    static_assert(glob<"a?c"_cs>("abc"));
+    static_assert(!glob<"a?c"_cs>("ac"));
+
+    static_assert(glob<"sensors.*.temp*"_cs>("sensors.room1.temp"));
+    static_assert(glob<"sensors.*.temp*"_cs>("sensors.a.b.temperature"));
+    static_assert(!glob<"sensors.*.temp*"_cs>("sensors.temp"));
+    static_assert(glob<"*a*b*c*"_cs>("xxaxxbxxcxx"));
+    static_assert(!glob<"*a*b*c*"_cs>("xxcxxbxxaxx"));
+    static_assert(glob<"*ab*ab"_cs>("abab"));
+    static_assert(!glob<"*ab*ab"_cs>("aba"));
+
+    static_assert(glob<"[!a-c]x"_cs>("dx"));
+    static_assert(!glob<"[^a-c]x"_cs>("bx"));
+    static_assert(glob<"[]]"_cs>("]"));
+    static_assert(glob<"v[[:digit:]][[:alpha:]_]"_cs>("v1_"));
+    static_assert(!glob<"v[[:digit:]][[:alpha:]_]"_cs>("vx_"));
+    static_assert(glob<"\\*[\\]x]"_cs>("*]"));
+    static_assert(!glob<"\\*"_cs>("a"));
+    static_assert(glob<"*[[:xdigit:]]?.bin"_cs>("dump-f0.bin"));
+
+    // No exponential blow-up on pathological inputs.
+    std::string input(10000, 'a');
+    if (glob<"*a*a*a*a*a*a*a*b"_cs>(input)) return 1;
+    input += 'b';
+    if (!glob<"*a*a*a*a*a*a*a*b"_cs>(input)) return 1;
+
+    std::cout << __FILE__ ": all tests passed." << std::endl;
+
+    return 0;
+}
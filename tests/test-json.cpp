@@ -0,0 +1,113 @@
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <string_view>
+
+#include "conststr/json.hpp"
+
+using namespace conststr::literal;
+using conststr::json::type;
+
+constexpr auto doc = R"({
+    "name": "conststr",
+    "version": 3,
+    "ratio": -1.25e2,
+    "stable": true,
+    "license": null,
+    "tags": ["header-only", "c++20", "é😀"],
+    "nested": {"empty": [], "obj": {}, "escaped": "a\"b\\c\n"}
+})"_json;
+
+int main() {
+    static_assert(doc.is_object());
+    static_assert(doc.size() == 7);
+    static_assert(doc["name"].as_string() == "conststr");
+    static_assert(doc["version"].is_integer());
+    static_assert(doc["version"].as_int() == 3);
+    static_assert(doc["ratio"].as_double() == -125.0);
+    static_assert(!doc["ratio"].is_integer());
+    static_assert(doc["stable"].as_bool());
+    static_assert(doc["license"].is_null());
+    static_assert(doc["tags"].size() == 3);
+    static_assert(doc["tags"][1].as_string() == "c++20");
+    static_assert(doc["tags"][2].as_string() == "\xC3\xA9\xF0\x9F\x98\x80");
+    static_assert(doc["tags"][3].type() == type::missing);
+    static_assert(doc["nested"]["empty"].is_array());
+    static_assert(doc["nested"]["empty"].size() == 0);
+    static_assert(doc["nested"]["obj"].is_object());
+    static_assert(doc["nested"]["escaped"].as_string() == "a\"b\\c\n");
+    static_assert(!doc["missing"]);
+    static_assert(!doc["missing"]["deeper"][0]);
+    static_assert(doc["name"].as_int(-1) == -1);
+    static_assert(!doc.contains("nam"));
+
+    static_assert("[1, [2, [3]], 4]"_json[2].as_int() == 4);
+    static_assert("0.5"_json.as_double() == 0.5);
+    static_assert("-9223372036854775807"_json.as_int() ==
+                  -9223372036854775807LL);
+    static_assert("-9223372036854775808"_json.is_integer());
+    static_assert("-9223372036854775808"_json.as_int() ==
+                  std::numeric_limits<std::int64_t>::min());
+    static_assert(!"9223372036854775808"_json.is_integer());
+    static_assert(!"12345678901234567890"_json.is_integer());
+
+    // Numbers are rounded like floating literals.
+    static_assert("0.1"_json.as_double() == 0.1);
+    static_assert("0.30000000000000004"_json.as_double() ==
+                  0.30000000000000004);
+    static_assert("1e23"_json.as_double() == 1e23);
+    static_assert("12345678901234567890"_json.as_double() ==
+                  12345678901234567890.0);
+    static_assert("9007199254740993"_json.as_double() == 9007199254740992.0);
+    static_assert("9007199254740993.00000000000000000000001"_json
+                      .as_double() == 9007199254740994.0);
+    static_assert("1.7976931348623157e308"_json.as_double() ==
+                  std::numeric_limits<double>::max());
+    static_assert("2.2250738585072014e-308"_json.as_double() ==
+                  std::numeric_limits<double>::min());
+    static_assert("4.9406564584124654e-324"_json.as_double() ==
+                  std::numeric_limits<double>::denorm_min());
+    static_assert("2.4703282292062328e-324"_json.as_double() ==
+                  std::numeric_limits<double>::denorm_min());
+    static_assert("2.4703282292062327e-324"_json.as_double() == 0);
+    static_assert("1e400"_json.as_double() ==
+                  std::numeric_limits<double>::infinity());
+    static_assert("-1e-400"_json.as_double() == 0);
+    static_assert("0.000000000000000000000000000001e30"_json.as_double() == 1);
+    static_assert("\"\""_json.as_string().empty());
+    static_assert(" false "_json.is_bool());
+
+    auto rejects = [](std::string_view text) {
+        try {
+            conststr::json::parser{text}.document();
+        } catch (const char *) {
+            return true;
+        }
+        return false;
+    };
+    if (rejects(R"("\ud83d\ude00")") || !rejects(R"("\udc00")") ||
+        !rejects(R"("\ud83d")") || !rejects("01") || !rejects("-"))
+        return 1;
+
+    std::string key = "version";
+    if (doc[key].as_int() != 3) return 1;
+
+    std::string joined;
+    doc["tags"].for_each([&](auto tag) {
+        joined += tag.as_string().substr(0, 2);
+        joined += ';';
+    });
+    if (joined != "he;c+;\xC3\xA9;") return 1;
+
+    std::size_t members = 0;
+    doc.for_each([&](std::string_view name, auto value) {
+        if (name == "nested" && value.size() != 3) members += 100;
+        ++members;
+    });
+    if (members != 7) return 1;
+
+    std::cout << __FILE__ ": all tests passed." << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,59 @@
+#include <iostream>
+#include <string>
+
+#include "reflect/lookup.hpp"
+
+struct Wide {
+    int alpha, beta, gamma, delta, epsilon, zeta, eta, theta, iota, kappa;
+    int lambda, mu, nu, xi, omicron, pi, rho, sigma, tau, upsilon;
+};
+
+struct Empty {};
+
+struct User {
+    int id;
+    int name;
+    int email;
+};
+
+template <>
+struct reflect::aliases<User>
+    : reflect::alias_map<reflect::alias<"uid", "id">,
+                         reflect::alias<"user_name", "name">,
+                         reflect::alias<"mail", "email">> {};
+
+int main() {
+    constexpr auto &wide = reflect::member_lookup<Wide>;
+    static_assert(wide.slots == 32);
+    static_assert(wide.find("alpha") == 0);
+    static_assert(wide.find("upsilon") == 19);
+    static_assert(wide.find("omega") == wide.npos);
+    static_assert(wide.find("") == wide.npos);
+    static_assert(reflect::member_lookup<Empty>.find("x") ==
+                  reflect::perfect_hash<0>::npos);
+
+    constexpr reflect::perfect_hash<3> colors({{
+        {"red", 0xFF0000},
+        {"green", 0x00FF00},
+        {"blue", 0x0000FF},
+    }});
+    static_assert(colors.find("green") == 0x00FF00);
+
+    constexpr auto &user = reflect::member_lookup<User>;
+    static_assert(user.find("id") == 0);
+    static_assert(user.find("uid") == 0);
+    static_assert(user.find("user_name") == 1);
+    static_assert(user.find("mail") == 2);
+    static_assert(user.find("email") == 2);
+    static_assert(user.find("user") == user.npos);
+
+    std::string key = "sigma";
+    if (wide.find(key) != 17) return 1;
+    key = "sigm";
+    if (wide.find(key) != wide.npos) return 1;
+    if (wide.find("") != wide.npos) return 1;
+
+    std::cout << __FILE__ ": all tests passed." << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,130 @@
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <utility>
+
+#if defined(_WIN32)
+int main() {
+    std::cout << __FILE__ ": skipped, mmap is not available." << std::endl;
+    return 0;
+}
+#else
+#include "reflect/mmap_table.hpp"
+
+struct Tick {
+    std::uint64_t ts;
+    char side;
+    double price;
+    std::int32_t qty[2];
+};
+
+struct OtherTick {
+    std::uint64_t ts;
+    char side;
+    double value;
+    std::int32_t qty[2];
+};
+
+template <reflect::table_layout Layout>
+int test_layout(const char *path) {
+    {
+        auto table = reflect::mmap_table<Tick>::create(path, Layout, 2);
+        for (std::uint64_t i = 0; i < 100; ++i)
+            table.append({i, i % 2 ? 'B' : 'S', 0.5 * i,
+                          {std::int32_t(i), -std::int32_t(i)}});
+        if (table.size() != 100 || table.capacity() < 100) return 1;
+        table.column<"price">()[3] = 42.0;
+        table.flush();
+    }
+
+    const auto table = reflect::mmap_table<Tick>::open(path);
+    if (table.layout() != Layout || table.size() != 100) return 1;
+
+    double sum = 0;
+    for (double price : table.column<"price">()) sum += price;
+    if (sum != 0.5 * 99 * 100 / 2 - 1.5 + 42.0) return 1;
+
+    auto ts = table.column<0>();
+    if (ts.end() - ts.begin() != 100 || ts[57] != 57) return 1;
+
+    Tick tick = table.load(77);
+    if (tick.ts != 77 || tick.side != 'B' || tick.price != 38.5) return 1;
+    if (tick.qty[0] != 77 || tick.qty[1] != -77) return 1;
+
+    bool rows_refused = false;
+    try {
+        if (table.rows()[77].ts != 77) return 1;
+    } catch (const std::runtime_error &) {
+        rows_refused = true;
+    }
+    if (rows_refused != (Layout != reflect::table_layout::rows)) return 1;
+
+    bool refused = false;
+    try {
+        reflect::mmap_table<OtherTick>::open(path);
+    } catch (const std::runtime_error &) {
+        refused = true;
+    }
+    if (!refused) return 1;
+
+    return 0;
+}
+
+template <typename F>
+bool throws(F f) {
+    try {
+        f();
+    } catch (const std::runtime_error &) {
+        return true;
+    }
+    return false;
+}
+
+// overwrite the 64-bit header field at `offset`
+void patch_header(const char *path, long offset, std::uint64_t value) {
+    std::FILE *file = std::fopen(path, "r+b");
+    std::fseek(file, offset, SEEK_SET);
+    std::fwrite(&value, sizeof(value), 1, file);
+    std::fclose(file);
+}
+
+int test_guards(const char *path) {
+    reflect::mmap_table<Tick>::create(path).append({1, 'B', 1.0, {1, 1}});
+
+    auto readonly = reflect::mmap_table<Tick>::open(path);
+    if (readonly.writable()) return 1;
+    if (!throws([&] { readonly.append({2, 'S', 2.0, {2, 2}}); })) return 1;
+    if (!throws([&] { readonly.store(0, {2, 'S', 2.0, {2, 2}}); })) return 1;
+    if (!throws([&] { readonly.column<"price">(); })) return 1;
+    if (!throws([&] { readonly.rows(); })) return 1;
+    if (std::as_const(readonly).column<"price">()[0] != 1.0) return 1;
+
+    auto open = [&] { reflect::mmap_table<Tick>::open(path); };
+    const long layout = 24, rows = 32, capacity = 40;
+    patch_header(path, rows, 2000);
+    if (!throws(open)) return 1;
+    patch_header(path, rows, 1);
+    patch_header(path, layout, 7);
+    if (!throws(open)) return 1;
+    patch_header(path, layout, 0);
+    patch_header(path, capacity, std::uint64_t(1) << 62);
+    if (!throws(open)) return 1;
+    patch_header(path, capacity, 1024);
+    if (throws(open)) return 1;
+
+    return 0;
+}
+
+int main() {
+    const char *path = "test-mmap_table.tbl";
+    int rows = test_layout<reflect::table_layout::rows>(path);
+    int columns = test_layout<reflect::table_layout::columns>(path);
+    int guards = test_guards(path);
+    std::remove(path);
+    if (rows || columns || guards) return 1;
+
+    std::cout << __FILE__ ": all tests passed." << std::endl;
+
+    return 0;
+}
+#endif
@@ -0,0 +1,151 @@
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "reflect/msgpack.hpp"
+
+enum class Side : std::int8_t { buy = 1, sell = -1 };
+
+struct Fill {
+    std::uint32_t id;
+    std::int64_t qty;
+    double price;
+    bool final;
+    Side side;
+    std::string venue;
+    std::vector<std::int16_t> legs;
+};
+
+struct Envelope {
+    std::string_view source;
+    Fill fill;
+    float score;
+};
+
+struct Partial {
+    double price;
+    std::uint32_t id;
+};
+
+struct PartialV2 {
+    double px;
+    std::uint64_t id;
+};
+
+template <>
+struct reflect::aliases<PartialV2>
+    : reflect::alias_map<reflect::alias<"price", "px">> {};
+
+struct Ticker {
+    char symbol[4];
+    std::uint32_t id;
+};
+
+struct Long {
+    int a_member_with_a_rather_long_name_exceeding_31;
+};
+
+using bytes_t = std::vector<std::byte>;
+
+static bytes_t bytes_of(std::initializer_list<int> list) {
+    bytes_t out;
+    for (int b : list) out.push_back(std::byte(b));
+    return out;
+}
+
+int main() {
+    namespace msgpack = reflect::msgpack;
+
+    static_assert(msgpack::key_of<Fill, 0> == "\xA2id");
+    static_assert(msgpack::key_of<Fill, 2> == "\xA5price");
+    static_assert(msgpack::key_of<Long, 0>.size() == 2 + 45);
+    static_assert(msgpack::key_of<Long, 0>[0] == char(0xD9));
+    static_assert(msgpack::map_header_of<Fill> == "\x87");
+
+    if (msgpack::write(Partial{1.5, 200}) !=
+        bytes_of({0x82, 0xA5, 'p', 'r', 'i', 'c', 'e', 0xCB, 0x3F, 0xF8, 0, 0,
+                  0, 0, 0, 0, 0xA2, 'i', 'd', 0xCC, 200}))
+        return 1;
+
+    Fill fill{70000, -5, 101.25, true, Side::sell, "XNAS", {1, -300, 30000}};
+    bytes_t out;
+    msgpack::write(fill, out);
+    Fill back = msgpack::read<Fill>(out);
+    if (back.id != 70000 || back.qty != -5 || back.price != 101.25 ||
+        !back.final || back.side != Side::sell || back.venue != "XNAS" ||
+        back.legs != fill.legs)
+        return 1;
+
+    // String views refer into the input.
+    out.clear();
+    msgpack::write(Envelope{"gateway", fill, 0.5f}, out);
+    Envelope env = msgpack::read<Envelope>(out);
+    if (env.source != "gateway" || env.score != 0.5f ||
+        env.fill.venue != "XNAS")
+        return 1;
+    if (static_cast<const void *>(env.source.data()) < out.data() ||
+        static_cast<const void *>(env.source.data()) > &out.back())
+        return 1;
+
+    // Unknown keys are skipped, missing ones stay value-initialized.
+    out.clear();
+    msgpack::write(fill, out);
+    Partial partial = msgpack::read<Partial>(out);
+    if (partial.id != 70000 || partial.price != 101.25) return 1;
+    Fill sparse = msgpack::read<Fill>(msgpack::write(Partial{2.0, 7}));
+    if (sparse.id != 7 || sparse.price != 2.0 || sparse.qty != 0) return 1;
+
+    // Payloads of the previous schema decode through aliases.
+    PartialV2 v2 = msgpack::read<PartialV2>(msgpack::write(Partial{3.5, 9}));
+    if (v2.px != 3.5 || v2.id != 9) return 1;
+
+    bool thrown = false;
+    try {
+        // {"id": -1} does not fit in std::uint32_t
+        msgpack::read<Partial>(bytes_of({0x81, 0xA2, 'i', 'd', 0xFF}));
+    } catch (const std::runtime_error &) {
+        thrown = true;
+    }
+    if (!thrown) return 1;
+
+    // char[N] members are str, up to the first '\0' or all N characters.
+    if (msgpack::write(Ticker{"AB", 1}) !=
+        bytes_of({0x82, 0xA6, 's', 'y', 'm', 'b', 'o', 'l', 0xA2, 'A', 'B',
+                  0xA2, 'i', 'd', 1}))
+        return 1;
+    Ticker ticker = msgpack::read<Ticker>(msgpack::write(Ticker{"AB", 1}));
+    if (std::string_view(ticker.symbol) != "AB" || ticker.id != 1) return 1;
+    ticker = msgpack::read<Ticker>(
+        msgpack::write(Ticker{{'M', 'S', 'F', 'T'}, 2}));
+    if (std::string_view(ticker.symbol, 4) != "MSFT") return 1;
+    thrown = false;
+    try {
+        // {"symbol": "GOOGL"} does not fit in char[4]
+        msgpack::read<Ticker>(bytes_of(
+            {0x81, 0xA6, 's', 'y', 'm', 'b', 'o', 'l', 0xA5, 'G', 'O', 'O',
+             'G', 'L'}));
+    } catch (const std::runtime_error &) {
+        thrown = true;
+    }
+    if (!thrown) return 1;
+
+    // Skipping deeply nested unknown values does not recurse.
+    bytes_t nested = bytes_of({0x81, 0xA1, 'x'});
+    nested.insert(nested.end(), 1000000, std::byte(0x91));
+    nested.push_back(std::byte(0xC0));
+    if (msgpack::read<Partial>(nested).id != 0) return 1;
+    nested.pop_back();
+    thrown = false;
+    try {
+        msgpack::read<Partial>(nested);
+    } catch (const std::runtime_error &) {
+        thrown = true;
+    }
+    if (!thrown) return 1;
+
+    std::cout << __FILE__ ": all tests passed." << std::endl;
+
+    return 0;
+}
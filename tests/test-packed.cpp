@@ -0,0 +1,77 @@
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "reflect/packed.hpp"
+
+enum class Level : std::uint8_t { off, low, mid, high };
+
+struct State {
+    bool online;
+    std::uint8_t flags;
+    Level level;
+    std::int32_t delta;
+};
+
+using packed_state =
+    reflect::packed<State, reflect::bits<"flags", 3>, reflect::bits<"level", 2>,
+                    reflect::bits<"delta", 10>>;
+
+struct Wide {
+    std::uint32_t a;
+    std::int64_t b;
+    std::uint16_t c;
+};
+
+using packed_wide = reflect::packed<Wide, reflect::bits<"a", 20>,
+                                    reflect::bits<"b", 50>>;
+
+int main() {
+    static_assert(packed_state::total_bits == 16);
+    static_assert(sizeof(packed_state) == 2);
+    static_assert(packed_state::bit_offset_of<2> == 4);
+    static_assert(packed_wide::total_bits == 86);
+    static_assert(sizeof(packed_wide) == 16);
+
+    constexpr packed_state cs(State{true, 6, Level::mid, -300});
+    static_assert(cs.get<"delta">() == -300);
+    static_assert(cs.get<"level">() == Level::mid);
+
+    packed_state s(State{true, 5, Level::high, -1});
+    if (!s.get<"online">() || s.get<"flags">() != 5 ||
+        s.get<"level">() != Level::high || s.get<"delta">() != -1)
+        return 1;
+    s.set<"flags">(2);
+    s.set<3>(511);
+    s.set<"online">(false);
+    State back = s.load();
+    if (back.online || back.flags != 2 || back.level != Level::high ||
+        back.delta != 511)
+        return 1;
+    // truncated to 10 bits
+    s.set<"delta">(1024 + 7);
+    if (s.get<"delta">() != 7) return 1;
+
+    // members spanning two words
+    packed_wide w(Wide{0xABCDE, -(std::int64_t(1) << 48), 0xFFFF});
+    if (w.get<"a">() != 0xABCDE || w.get<"b">() != -(std::int64_t(1) << 48) ||
+        w.get<"c">() != 0xFFFF)
+        return 1;
+    w.set<"b">(123456789012345);
+    if (w.get<"b">() != 123456789012345 || w.get<"a">() != 0xABCDE ||
+        w.get<"c">() != 0xFFFF)
+        return 1;
+
+    std::vector<packed_state> table(1000);
+    for (std::size_t i = 0; i < table.size(); ++i)
+        table[i].store({i % 2 == 0, std::uint8_t(i % 8), Level(i % 4),
+                        std::int32_t(i % 1000) - 500});
+    for (std::size_t i = 0; i < table.size(); ++i)
+        if (table[i].get<"delta">() != std::int32_t(i % 1000) - 500 ||
+            table[i].get<"flags">() != i % 8)
+            return 1;
+
+    std::cout << __FILE__ ": all tests passed." << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,111 @@
+#define CONSTSTR_NO_IOSTREAM
+
+#include <cstdint>
+#include <cstdio>
+#include <iterator>
+#include <string>
+#include <system_error>
+#include <vector>
+#include <version>
+#ifdef __cpp_lib_format
+#include <format>
+#endif
+
+#include "reflect/print.hpp"
+
+#ifdef _GLIBCXX_IOSTREAM
+#error "reflect/print.hpp includes <iostream> despite CONSTSTR_NO_IOSTREAM"
+#endif
+
+enum class Kind { read = 1, write = 2 };
+
+struct Inner {
+    char tag;
+    bool ok;
+};
+
+struct Event {
+    std::uint64_t id;
+    double value;
+    Kind kind;
+    std::string user;
+    std::vector<int> codes;
+    Inner inner;
+};
+
+struct Nothing {};
+
+struct Ticker {
+    char symbol[4];
+    char venue[8];
+};
+
+#ifdef __cpp_lib_format
+template <>
+struct std::formatter<Event> {
+    constexpr auto parse(std::format_parse_context &ctx) { return ctx.begin(); }
+
+    auto format(const Event &e, std::format_context &ctx) const {
+        return reflect::print(e, ctx.out());
+    }
+};
+#endif
+
+int main() {
+    static_assert(reflect::print_prefix_of<Event, 0> == "{id: ");
+    static_assert(reflect::print_prefix_of<Event, 3> == ", user: ");
+
+    Event e{7, 2.5, Kind::write, "root", {1, 2}, {'x', true}};
+    const std::string expected =
+        "{id: 7, value: 2.5, kind: 2, user: \"root\", codes: [1, 2], "
+        "inner: {tag: 'x', ok: true}}";
+
+    std::string out;
+    reflect::print(e, std::back_inserter(out));
+    if (out != expected) return 1;
+
+    char buffer[16];
+    std::size_t size = reflect::print(e, std::span<char>(buffer));
+    if (size != expected.size()) return 1;
+    if (std::string_view(buffer, sizeof(buffer)) != expected.substr(0, 16))
+        return 1;
+
+    std::FILE *file = std::tmpfile();
+    if (!file) return 1;
+    for (int i = 0; i < 1000; ++i) reflect::print(e, file);
+    reflect::print(Nothing{}, file);
+    if (std::ftell(file) != long(expected.size() * 1000 + 2)) return 1;
+    std::rewind(file);
+    std::string head(expected.size(), '\0');
+    if (std::fread(head.data(), 1, head.size(), file) != head.size() ||
+        head != expected)
+        return 1;
+    std::fclose(file);
+
+    // Short writes are reported instead of dropped.
+    file = std::fopen("/dev/null", "r");
+    if (file) {
+        bool thrown = false;
+        try {
+            reflect::print(e, file);
+        } catch (const std::system_error &) {
+            thrown = true;
+        }
+        std::fclose(file);
+        if (!thrown) return 1;
+    }
+
+    // Char arrays stop at the first null or at their end, whichever is first.
+    Ticker t{{'A', 'B', 'C', 'D'}, "XNYS"};
+    out.clear();
+    reflect::print(t, std::back_inserter(out));
+    if (out != "{symbol: \"ABCD\", venue: \"XNYS\"}") return 1;
+
+#ifdef __cpp_lib_format
+    if (std::format("{}", e) != expected) return 1;
+#endif
+
+    std::printf("%s: all tests passed.\n", __FILE__);
+
+    return 0;
+}
@@ -1,3 +1,5 @@
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <iostream>
 #include <memory>
@@ -25,6 +27,67 @@ struct MyStruct {
     std::reference_wrapper<int> ref_wrapper = value;
 };
 
+struct Point {
+    int x;
+    double y;
+};
+
+struct PointRenamed {
+    int x;
+    double z;
+};
+
+struct PointLong {
+    long long x;
+    double y;
+};
+
+namespace v1 {
+enum class Color : std::uint8_t { red, green };
+}
+
+namespace v2 {
+enum Color : unsigned char { red, green, blue };
+}
+
+struct Pixel {
+    v1::Color color;
+};
+
+struct PixelV2 {
+    v2::Color color;
+};
+
+struct PixelRaw {
+    std::uint8_t color;
+};
+
+struct Tag {
+    char tag;
+};
+
+struct TagSigned {
+    signed char tag;
+};
+
+struct TagUnsigned {
+    unsigned char tag;
+};
+
+struct Shape {
+    char tag;
+    Point origin;
+    short sides[3];
+    bool filled;
+};
+
+struct ShapeV2 {
+    char tag;
+    PointRenamed origin;
+    short sides[3];
+    bool filled;
+};
+
 int main() {
     static_assert(reflect::number_of_members<MyStruct> == 10);
 
@@ -94,6 +157,34 @@ int main() {
     member4 = (void *)0x1919810;
     if (s.pointer != (void *)0x1919810) return 1;
 
+    static_assert(reflect::type_name<int> == "int");
+    static_assert(reflect::type_name<Point> == "Point");
+
+    static_assert(reflect::offset_of<Shape, 0> == offsetof(Shape, tag));
+    static_assert(reflect::offset_of<Shape, 1> == offsetof(Shape, origin));
+    static_assert(reflect::offset_of<Shape, 2> == offsetof(Shape, sides));
+    static_assert(reflect::offset_of<Shape, 3> == offsetof(Shape, filled));
+
+    static_assert(reflect::reflectable<Shape>);
+    static_assert(!reflect::reflectable<std::array<int, 2>>);
+    static_assert(!reflect::reflectable<std::string>);
+
+    static_assert(reflect::schema_hash<Point> ==
+                  reflect::schema_hash<decltype(Shape::origin)>);
+    static_assert(reflect::schema_hash<Point> !=
+                  reflect::schema_hash<PointRenamed>);
+    static_assert(reflect::schema_hash<Point> !=
+                  reflect::schema_hash<PointLong>);
+    static_assert(reflect::schema_hash<Shape> != reflect::schema_hash<ShapeV2>);
+    static_assert(reflect::schema_hash<Pixel> ==
+                  reflect::schema_hash<PixelV2>);
+    static_assert(reflect::schema_hash<Pixel> !=
+                  reflect::schema_hash<PixelRaw>);
+    static_assert(reflect::schema_hash<Tag> !=
+                  reflect::schema_hash<TagSigned>);
+    static_assert(reflect::schema_hash<Tag> !=
+                  reflect::schema_hash<TagUnsigned>);
+
     std::cout << __FILE__ ": all tests passed." << std::endl;
 
     return 0;
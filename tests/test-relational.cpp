@@ -0,0 +1,103 @@
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "reflect/relational.hpp"
+
+struct Trade {
+    std::string symbol;
+    std::int32_t qty;
+    double price;
+};
+
+struct User {
+    int id;
+    std::string name;
+};
+
+struct Order {
+    int id;
+    int user_id;
+    double amount;
+};
+
+struct Account {
+    unsigned owner;
+    int balance;
+};
+
+struct Login {
+    const char *user;
+    int count;
+};
+
+int main() {
+    using rec = reflect::record<reflect::field<"a", int>,
+                                reflect::field<"bb", double>>;
+    static_assert(rec::index_of<"bb"> == 1);
+    static_assert(rec::name_of<0> == "a");
+
+    std::vector<Trade> trades;
+    const char *symbols[] = {"AAPL", "MSFT", "IBM"};
+    for (int i = 0; i < 1000; ++i)
+        trades.push_back({symbols[i % 3], i % 10, 100.0 + i});
+
+    auto groups =
+        reflect::group_by<"symbol">(trades, reflect::sum_of<"qty">,
+                                    reflect::count_of,
+                                    reflect::max_of<"price">,
+                                    reflect::min_of<"price">);
+    using group_t = decltype(groups)::value_type;
+    static_assert(group_t::name_of<1> == "sum_qty");
+    static_assert(group_t::name_of<3> == "max_price");
+    static_assert(std::same_as<std::remove_cvref_t<decltype(
+                                   groups[0].get<"sum_qty">())>,
+                               std::int64_t>);
+    if (groups.size() != 3) return 1;
+    if (groups[0].get<"symbol">() != "AAPL") return 1;
+    if (groups[0].get<"count">() != 334) return 1;
+    if (groups[2].get<"count">() != 333) return 1;
+    std::int64_t total = 0;
+    for (const auto &g : groups) total += g.get<"sum_qty">();
+    if (total != 4500) return 1;
+    if (groups[1].get<"max_price">() != 1097.0) return 1;
+    if (groups[1].get<"min_price">() != 101.0) return 1;
+
+    std::vector<User> users = {{1, "alice"}, {2, "bob"}, {3, "carol"}};
+    std::vector<Order> orders = {
+        {10, 2, 5.0}, {11, 1, 7.5}, {12, 2, 1.0}, {13, 9, 3.0}};
+    auto joined = reflect::hash_join<"id", "user_id">(users, orders);
+    using joined_t = decltype(joined)::value_type;
+    static_assert(joined_t::size == 5);
+    static_assert(joined_t::name_of<2> == "right_id");
+    static_assert(joined_t::name_of<3> == "user_id");
+    if (joined.size() != 3) return 1;
+    if (joined[0].get<"name">() != "alice" || joined[0].get<"amount">() != 7.5)
+        return 1;
+    if (joined[1].get<"right_id">() != 10 || joined[2].get<"right_id">() != 12)
+        return 1;
+    if (joined[2].get<"id">() != 2) return 1;
+
+    // -1 == 0xFFFFFFFFu, so mixed-signedness keys must still match.
+    std::vector<User> signed_users = {{-1, "root"}, {4, "dave"}};
+    std::vector<Account> accounts = {{0xFFFFFFFFu, 100}, {4u, 20}, {5u, 1}};
+    auto owned = reflect::hash_join<"id", "owner">(signed_users, accounts);
+    if (owned.size() != 2) return 1;
+    if (owned[0].get<"name">() != "root" || owned[0].get<"balance">() != 100)
+        return 1;
+    if (owned[1].get<"balance">() != 20) return 1;
+
+    // String keys are compared by content, also against `const char *`.
+    char bob[] = "bob";
+    std::vector<Login> logins = {{bob, 3}, {"alice", 1}, {"mallory", 9}};
+    auto logged = reflect::hash_join<"name", "user">(users, logins);
+    if (logged.size() != 2) return 1;
+    if (logged[0].get<"name">() != "alice" || logged[0].get<"count">() != 1)
+        return 1;
+    if (logged[1].get<"count">() != 3) return 1;
+
+    std::cout << __FILE__ ": all tests passed." << std::endl;
+
+    return 0;
+}
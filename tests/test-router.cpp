@@ -0,0 +1,81 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "conststr/router.hpp"
+
+using namespace conststr::literal;
+
+struct list_users {
+    std::string operator()(auto, int) const { return "list"; }
+};
+
+struct get_user {
+    std::string operator()(auto params, int) const {
+        return "user " + std::string(params.template get<"id">());
+    }
+};
+
+struct new_user {
+    std::string operator()(auto, int) const { return "new"; }
+};
+
+struct get_post {
+    std::string operator()(auto params, int n) const {
+        return std::string(params.template get<"id">()) + "/" +
+               std::string(params.template get<"pid">()) + "#" +
+               std::to_string(n);
+    }
+};
+
+struct count {
+    void operator()(auto, int &hits) const { ++hits; }
+};
+
+struct root {
+    std::string operator()(auto, int) const { return "root"; }
+};
+
+using routes = conststr::router<
+    conststr::route<"/users"_cs, list_users>,
+    conststr::route<"/users/{id}"_cs, get_user>,
+    conststr::route<"/users/new"_cs, new_user>,
+    conststr::route<"/users/{id}/posts/{pid}"_cs, get_post>,
+    conststr::route<"/"_cs, root>>;
+
+int main() {
+    static_assert(routes::max_captures == 2);
+    static_assert(conststr::route_params<"/a/{x}/b/{y}"_cs, 2>::index_of<
+                      "y"_cs> == 1);
+    static_assert(routes::match("/users").index == 0);
+    static_assert(routes::match("/users/42").index == 1);
+    static_assert(routes::match("/users/new").index == 2);
+    static_assert(routes::match("/users/7/posts/9").captures[1] == "9");
+    static_assert(routes::match("/").index == 4);
+    static_assert(!routes::match("/users/7/posts"));
+    static_assert(!routes::match("/users/"));
+    static_assert(!routes::match("users"));
+    static_assert(!routes::match(""));
+
+    // falls back to the parameter when the static branch dead-ends
+    constexpr auto m = routes::match("/users/new/posts/1");
+    static_assert(m.index == 3 && m.captures[0] == "new");
+
+    if (*routes::dispatch("/users/42", 0) != "user 42") return 1;
+    if (*routes::dispatch("/users/new", 0) != "new") return 1;
+    if (*routes::dispatch("/users/5/posts/abc", 3) != "5/abc#3") return 1;
+    if (routes::dispatch("/nope", 0)) return 1;
+
+    int hits = 0;
+    using void_routes =
+        conststr::router<conststr::route<"/ping"_cs, count>,
+                         conststr::route<"/a/{x}"_cs, count>>;
+    if (!void_routes::dispatch("/ping", hits) ||
+        !void_routes::dispatch("/a/b", hits) ||
+        void_routes::dispatch("/a", hits) || hits != 2)
+        return 1;
+
+    std::cout << __FILE__ ": all tests passed." << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,57 @@
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "conststr/scan.hpp"
+
+using namespace conststr::literal;
+
+int main() {
+    using fmt = conststr::scan_format<"[{}] {}:{} {{x}}"_cs>;
+    static_assert(fmt::fields == 3);
+    static_assert(fmt::literal<0>() == "[");
+    static_assert(fmt::literal<1>() == "] ");
+    static_assert(fmt::literal<2>() == ":");
+    static_assert(fmt::literal<3>() == " {x}");
+
+    std::string_view level;
+    int hour = 0;
+    unsigned minute = 0;
+    if (!conststr::scan<"[{}] {}:{} {{x}}"_cs>("[warn] 12:34 {x}", level, hour,
+                                               minute))
+        return 1;
+    if (level != "warn" || hour != 12 || minute != 34) return 1;
+
+    std::string host;
+    std::uint16_t port = 0;
+    double latency = 0;
+    if (!conststr::scan<"{}:{} took {}ms"_cs>("db01:5432 took 1.25ms", host,
+                                             port, latency))
+        return 1;
+    if (host != "db01" || port != 5432 || latency != 1.25) return 1;
+
+    std::string_view message;
+    int code = 0;
+    char unit = 0;
+    if (!conststr::scan<"E{}: {} ({})"_cs>("E42: disk full (s)", code,
+                                           message, unit))
+        return 1;
+    if (code != 42 || message != "disk full" || unit != 's') return 1;
+    // adjacent placeholders take the longest numbers
+    long a = 0;
+    double b = 0;
+    if (!conststr::scan<"{}{} end"_cs>("-7.5e1 end", a, b)) return 1;
+    if (a != -7 || b != 5.0) return 1;
+
+    // mismatches
+    if (conststr::scan<"{}:{}"_cs>("12-34", hour, minute)) return 1;
+    if (conststr::scan<"{}:{}"_cs>("x:34", hour, minute)) return 1;
+    if (conststr::scan<"{}:{}"_cs>("-1:34", minute, hour)) return 1;
+    if (conststr::scan<"{} ok"_cs>("5 ok!", hour)) return 1;
+    if (conststr::scan<"[{}]"_cs>("(a]", level)) return 1;
+
+    std::cout << __FILE__ ": all tests passed." << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,108 @@
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "reflect/sort.hpp"
+
+enum class Side : std::int8_t { sell = -1, buy = 1 };
+
+struct Tick {
+    char symbol[4];
+    std::int64_t ts;
+    double price;
+    Side side;
+};
+
+struct Named {
+    std::string name;
+    int rank;
+};
+
+struct Labeled {
+    const char *label;
+    int rank;
+};
+
+struct Reading {
+    double value;
+    int seq;
+};
+
+int main() {
+    using key = reflect::sort_key<Tick, "symbol", "ts">;
+    static_assert(key::size == 12);
+    static_assert(key::exact);
+    static_assert(!reflect::sort_key<Named, "name">::exact);
+    static_assert(reflect::sort_key<Named, "name", "rank">::size == 8);
+
+    std::mt19937 rng(42);
+    std::vector<Tick> ticks;
+    const char *symbols[] = {"AAPL", "MSFT", "AMZN", "IBM\0"};
+    for (int i = 0; i < 5000; ++i) {
+        Tick tick{};
+        std::copy_n(symbols[rng() % 4], 4, tick.symbol);
+        tick.ts = std::int64_t(rng() % 2000) - 1000;
+        tick.price = (double(rng() % 20000) - 10000) / 8;
+        tick.side = rng() % 2 ? Side::buy : Side::sell;
+        ticks.push_back(tick);
+    }
+
+    auto expected = ticks;
+    std::stable_sort(expected.begin(), expected.end(),
+                     [](const Tick &a, const Tick &b) {
+                         int cmp = std::memcmp(a.symbol, b.symbol, 4);
+                         return cmp != 0 ? cmp < 0 : a.ts < b.ts;
+                     });
+    reflect::sort_by<"symbol", "ts">(ticks);
+    for (std::size_t i = 0; i < ticks.size(); ++i)
+        if (std::memcmp(&ticks[i], &expected[i], sizeof(Tick)) != 0) return 1;
+
+    expected = ticks;
+    std::stable_sort(expected.begin(), expected.end(),
+                     [](const Tick &a, const Tick &b) {
+                         return a.side != b.side ? a.side < b.side
+                                                 : a.price < b.price;
+                     });
+    reflect::sort_by<"side", "price">(ticks);
+    for (std::size_t i = 0; i < ticks.size(); ++i)
+        if (std::memcmp(&ticks[i], &expected[i], sizeof(Tick)) != 0) return 1;
+
+    std::vector<Named> names = {{"charlie-long-name", 1},
+                                {"charlie-long-alias", 2},
+                                {"bob", 3},
+                                {"alice", 4},
+                                {"bob", 0}};
+    reflect::sort_by<"name", "rank">(names);
+    if (names[0].name != "alice" || names[1].rank != 0 || names[2].rank != 3)
+        return 1;
+    if (names[3].name != "charlie-long-alias" ||
+        names[4].name != "charlie-long-name")
+        return 1;
+
+    // Pointers to equal strings tie on content, not on their addresses:
+    // ranks are given in descending address order, so comparing the
+    // pointers would sort them backwards.
+    char first[] = "alpha-long", second[] = "alpha-long";
+    const char *same[] = {first, "alpha-long", second};
+    std::sort(std::begin(same), std::end(same), std::greater<>{});
+    std::vector<Labeled> labels = {
+        {"beta", 0}, {same[2], 2}, {same[0], 0}, {same[1], 1}};
+    reflect::sort_by<"label", "rank">(labels);
+    for (int i = 0; i < 3; ++i)
+        if (labels[i].rank != i) return 1;
+
+    // -0.0 == +0.0, so a stable sort keeps their order.
+    std::vector<Reading> readings = {{0.0, 0}, {-0.0, 1}, {-1.0, 2}, {0.0, 3}};
+    reflect::sort_by<"value">(readings);
+    if (readings[0].seq != 2 || readings[1].seq != 0 ||
+        readings[2].seq != 1 || readings[3].seq != 3)
+        return 1;
+
+    std::cout << __FILE__ ": all tests passed." << std::endl;
+
+    return 0;
+}
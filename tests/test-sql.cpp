@@ -0,0 +1,76 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "reflect/sql.hpp"
+
+using namespace conststr::literal;
+
+struct User {
+    int id;
+    std::string name;
+    std::string email;
+    double score;
+};
+
+struct Single {
+    int id;
+};
+
+struct Line {
+    int order;
+    int key;
+};
+
+int main() {
+    namespace sql = reflect::sql;
+
+    constexpr auto insert_user = sql::insert<User>("users"_cs);
+    static_assert(insert_user ==
+                  "INSERT INTO users (\"id\", \"name\", \"email\", "
+                  "\"score\") VALUES (?, ?, ?, ?)");
+    static_assert(sql::select<User>("users"_cs) ==
+                  "SELECT \"id\", \"name\", \"email\", \"score\" "
+                  "FROM users");
+    static_assert(sql::select<User, "email">("users"_cs) ==
+                  "SELECT \"id\", \"name\", \"email\", \"score\" "
+                  "FROM users WHERE \"email\" = ?");
+    static_assert(sql::update<User, "id">("users"_cs) ==
+                  "UPDATE users SET \"name\" = ?, \"email\" = ?, "
+                  "\"score\" = ? WHERE \"id\" = ?");
+    static_assert(sql::update<User, "score">("users"_cs) ==
+                  "UPDATE users SET \"id\" = ?, \"name\" = ?, "
+                  "\"email\" = ? WHERE \"score\" = ?");
+    static_assert(sql::insert<Single>("t"_cs) ==
+                  "INSERT INTO t (\"id\") VALUES (?)");
+    // Reserved words are valid column names once quoted.
+    static_assert(sql::update<Line, "key">("main.lines"_cs) ==
+                  "UPDATE main.lines SET \"order\" = ? WHERE \"key\" = ?");
+    static_assert(reflect::fnv1a(0, insert_user) !=
+                  reflect::fnv1a(0, sql::select<User>("users"_cs)));
+
+    User user{42, "ann", "ann@example.com", 9.5};
+    std::vector<std::string> bound;
+    auto record = [&](std::size_t pos, const auto &value) {
+        if (pos != bound.size() + 1) bound.push_back("bad position");
+        if constexpr (std::is_same_v<std::remove_cvref_t<decltype(value)>,
+                                     std::string>)
+            bound.push_back(value);
+        else
+            bound.push_back(std::to_string(value));
+    };
+    sql::bind(user, record);
+    if (bound != std::vector<std::string>{"42", "ann", "ann@example.com",
+                                          "9.500000"})
+        return 1;
+
+    bound.clear();
+    sql::bind_update<"id">(user, record);
+    if (bound != std::vector<std::string>{"ann", "ann@example.com",
+                                          "9.500000", "42"})
+        return 1;
+
+    std::cout << __FILE__ ": all tests passed." << std::endl;
+
+    return 0;
+}
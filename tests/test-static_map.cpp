@@ -0,0 +1,49 @@
+#include <iostream>
+#include <string>
+
+#include "conststr/static_map.hpp"
+
+using namespace conststr::literal;
+namespace charutils = conststr::charutils;
+
+using headers = conststr::ci_static_map<
+    "Host"_cs, "Content-Type"_cs, "Content-Length"_cs, "Accept"_cs,
+    "Accept-Encoding"_cs, "Connection"_cs, "User-Agent"_cs, "Via"_cs,
+    "Call-ID"_cs, "CSeq"_cs, "From"_cs, "To"_cs, "Max-Forwards"_cs>;
+
+using methods = conststr::static_map<"GET"_cs, "POST"_cs, "PUT"_cs>;
+
+int main() {
+    constexpr auto fold = conststr::ascii_case_insensitive::fold;
+    constexpr bool fold_is_tolower = [&] {
+        for (int ch = 0; ch < 256; ++ch)
+            if (fold(char(ch)) !=
+                (unsigned char)(ch < 128 ? charutils::tolower(char(ch))
+                                         : char(ch)))
+                return false;
+        return true;
+    }();
+    static_assert(fold_is_tolower);
+
+    static_assert(headers::size == 13);
+    static_assert(headers::find("Host") == 0);
+    static_assert(headers::find("host") == 0);
+    static_assert(headers::find("CONTENT-LENGTH") == 2);
+    static_assert(headers::find("call-id") == 8);
+    static_assert(headers::find("max-FORWARDS") == 12);
+    static_assert(headers::find("Content") == headers::npos);
+    static_assert(headers::find("") == headers::npos);
+    static_assert(!headers::contains("X-Forwarded-For"));
+
+    static_assert(methods::find("POST") == 1);
+    static_assert(methods::find("post") == methods::npos);
+
+    std::string line = "cSeQ";
+    if (headers::find(line) != 9) return 1;
+    line = "Acceptx";
+    if (headers::contains(line)) return 1;
+
+    std::cout << __FILE__ ": all tests passed." << std::endl;
+
+    return 0;
+}
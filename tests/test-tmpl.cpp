@@ -0,0 +1,78 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "conststr/tmpl.hpp"
+
+using namespace conststr::literal;
+
+struct item {
+    std::string_view title;
+    double price;
+};
+
+struct notification {
+    std::string name;
+    int count;
+    bool urgent;
+    std::vector<item> items;
+    std::vector<std::string_view> tags;
+    std::string coupon;
+    char grade;
+};
+
+using greeting = conststr::tmpl<"Hello {{name}}, you have {{count}} msgs"_cs>;
+
+using digest = conststr::tmpl<
+    "{{#urgent}}URGENT {{/urgent}}{{name}}:"
+    "{{#items}} {{title}}={{price}} for {{ name }};{{/items}}"
+    "{{^items}} nothing{{/items}}"
+    "{{! tags follow }}"
+    "{{#tags}}[{{.}}]{{/tags}}"
+    "{{#coupon}} code {{{.}}}{{/coupon}}"
+    "{{^coupon}} no code{{/coupon}}"
+    " grade {{&grade}}"_cs>;
+
+// 1000 tokens, more than the default template instantiation depth.
+#define TIMES5(s) s s s s s
+#define TIMES10(s) TIMES5(s) TIMES5(s)
+using long_list =
+    conststr::tmpl<TIMES5(TIMES10(TIMES10("{{count}},"))) ""_cs>;
+#undef TIMES10
+#undef TIMES5
+
+int main() {
+    static_assert(greeting::tokens.size() == 5);
+    static_assert(greeting::literal_size == 22);
+    static_assert(greeting::tokens[1].kind == conststr::tmpl_token_kind::slot);
+    static_assert(conststr::tmpl<"plain"_cs>::tokens.size() == 1);
+    static_assert(conststr::tmpl<""_cs>::tokens.size() == 0);
+
+    notification n{"Ann", 3, false, {}, {}, "", 'B'};
+    if (greeting::render(n) != "Hello Ann, you have 3 msgs") return 1;
+    if (greeting::max_size(n) < greeting::literal_size + 3 + 11) return 1;
+    if (digest::render(n) != "Ann: nothing no code grade B") return 1;
+
+    n.urgent = true;
+    n.items = {{"book", 12.5}, {"pen", 2}};
+    n.tags = {"a", "b"};
+    n.coupon = "X1";
+    if (digest::render(n) !=
+        "URGENT Ann: book=12.5 for Ann; pen=2 for Ann;[a][b] code X1 grade B")
+        return 1;
+
+    std::string counts;
+    for (int i = 0; i < 500; ++i) counts += "3,";
+    static_assert(long_list::tokens.size() == 1000);
+    if (long_list::render(n) != counts) return 1;
+
+    char buffer[256];
+    char *end = greeting::render_to(n, buffer);
+    if (std::string_view(buffer, end - buffer) != "Hello Ann, you have 3 msgs")
+        return 1;
+
+    std::cout << __FILE__ ": all tests passed." << std::endl;
+
+    return 0;
+}
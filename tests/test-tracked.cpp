@@ -0,0 +1,73 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "reflect/tracked.hpp"
+
+struct Account {
+    int id;
+    std::string email;
+    double balance;
+    bool active;
+};
+
+struct Point {
+    int x;
+    int y;
+    int z;
+};
+
+// Tracking works in constant evaluation.
+static_assert([] {
+    reflect::tracked<Point> point(Point{1, 2, 3});
+    point.set<"y">(5);
+    point.set<2>(7);
+    int sum = 0;
+    point.for_each_dirty([&](auto, int value) { sum += value; });
+    return sum == 12 && point.dirty<"z">() && !point.dirty<0>() &&
+           point.dirty_bits()[0] == 0b110;
+}());
+
+int main() {
+    reflect::tracked<Account> account(Account{7, "a@example.com", 10.0, true});
+    static_assert(decltype(account)::size == 4);
+    if (account.dirty()) return 1;
+    if (account.get<"email">() != "a@example.com" || account->id != 7)
+        return 1;
+
+    account.set<"balance">(12.5);
+    account.set<1>("b@example.com");
+    if (!account.dirty() || !account.dirty<"balance">() ||
+        !account.dirty<1>() || account.dirty<"id">())
+        return 1;
+    if (account.dirty_bits()[0] != 0b0110) return 1;
+
+    std::vector<std::string> names;
+    std::string email;
+    account.for_each_dirty([&](auto name, const auto &value) {
+        names.emplace_back(std::string_view(name));
+        if constexpr (std::is_same_v<std::remove_cvref_t<decltype(value)>,
+                                     std::string>)
+            email = value;
+    });
+    if (names != std::vector<std::string>{"email", "balance"}) return 1;
+    if (email != "b@example.com") return 1;
+
+    account.clear();
+    if (account.dirty()) return 1;
+    int visited = 0;
+    account.for_each_dirty([&](auto, const auto &) { ++visited; });
+    if (visited != 0) return 1;
+
+    account.mark_all();
+    if (account.dirty_bits()[0] != 0b1111) return 1;
+    // The result of the callable is discarded.
+    account.for_each_dirty([&](auto, const auto &) { return ++visited; });
+    if (visited != 4) return 1;
+    if (account.value().balance != 12.5) return 1;
+
+    std::cout << __FILE__ ": all tests passed." << std::endl;
+
+    return 0;
+}